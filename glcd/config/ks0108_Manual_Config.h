@@ -154,6 +154,18 @@
 #error "Check that the number of Chip Select pins is correct for the configured panel size"
 #endif
 
+/*
+ * Panels with a separate chip select pin for each chip can select all the chips
+ * at once, which lets clearing and filling the display write every chip in parallel.
+ * Uncomment the line below that matches the number of chip select pins
+ * and use LOW instead of HIGH if the chip selects are active low.
+ * Do not use it on panels where the pins are decoded to select the chips,
+ * like the three and four chip panels that use two select pins.
+ */
+//#define glcd_CHIPALL  glcdCSEL1,HIGH, glcdCSEL2,HIGH                                  // two pins
+//#define glcd_CHIPALL  glcdCSEL1,HIGH, glcdCSEL2,HIGH, glcdCSEL3,HIGH                  // three pins
+//#define glcd_CHIPALL  glcdCSEL1,HIGH, glcdCSEL2,HIGH, glcdCSEL3,HIGH, glcdCSEL4,HIGH  // four pins
+
 /*********************************************************/
 /*  End of Chip Select Configuration                     */
 /*********************************************************/
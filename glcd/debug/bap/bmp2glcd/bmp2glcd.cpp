@@ -30,6 +30,7 @@
  *         -pgm (create header with __attribute__ progmem for AVR)
  *         -pic30 (create header with __attribute__((space(auto_psv))) for PIC30
  *         -glcdlib (create bitmap data in glcd library format)
+ *         -packbits (compress the glcd library format bitmap data)
  *
  *          (Note! there has to be space between switches -h and -w)
  *    
@@ -38,6 +39,7 @@
 #include <fstream>
 #include "EasyBMP.h"
 #include <stdlib.h>
+#include <vector>
 
 
 #define WRITE_BYTES_PER_LINE 16
@@ -47,12 +49,14 @@ using namespace std;
 //Forward declarations
 void printHelp(void);
 bool saveHeaderFile(string name, BMP &image);
+void savePackBits(ofstream &out, BMP &image);
 
 //global variables
 bool verbose=false;
 bool pgm=false;
 bool pic30=false;
 bool glcdlib=false;
+bool packbits=false;
 
 int main( int argc, char* argv[] )
 {
@@ -87,6 +91,14 @@ int main( int argc, char* argv[] )
       pic30=true;      
 	else if(strcmp (argv[i],"-glcdlib")==0)
       glcdlib=true;      
+	else if(strcmp (argv[i],"-packbits")==0)
+      packbits=true;      
+  }
+
+  if(packbits && !glcdlib)
+  {
+	cerr << "Error: -packbits can only be used with glcdlib Mode" << endl;
+	return -1;
   }
 
   // Make sure no scaling when using glcdlib format
@@ -187,6 +199,7 @@ void printHelp(void){
        << "\t-pgm\t\tcreate header with __attribute__ ((progmem)) for AVR"<< endl
        << "\t-pic30\t\tcreate header whith __attribute__((space(auto_psv))) for PIC30" << endl
        << "\t-glcdlib\tcreate bitmap data in GLCDlib format" << endl
+       << "\t-packbits\tcompress the GLCDlib format bitmap data" << endl
 	<<endl
        << "This program converts a bitmap to binary bitmap (black and white) with 8bit page"  
        <<endl
@@ -271,12 +284,26 @@ bool saveHeaderFile(string name, BMP &image){
   else
     out << "static char "<< basename.c_str() <<"_bmp[]={"<<endl;
 
+  if(packbits)
+  {
+	out << "0,\t// compressed bitmap (glcdlib format)" << endl;
+	out << "1,\t// GLCD_BITMAP_PACKBITS" << endl;
+  }
   if(glcdlib)
   {
 	out << image.TellWidth() << ",\t// bitmap width  (glcdlib format)" << endl;
 	out << image.TellHeight() << ",\t// bitmap height (glcdlib format)" << endl;
   }
 
+  if(packbits)
+  {
+	savePackBits(out, image);
+	out << "};"<<endl
+	    << "#endif  //define _"<<basename.c_str()<<"_H " <<endl;
+	out.close();
+	return true;
+  }
+
   count=image.TellWidth()*image.TellHeight();
 
   j=0;
@@ -340,3 +367,68 @@ bool saveHeaderFile(string name, BMP &image){
 
   return true;
 }
+
+//--------------------------------------------------------------------------
+//Get the page byte of column col: 8 pixels down from row page*8,
+//with the top pixel in bit 0 and rows below the image clear
+//
+static int pageByte(BMP &image, int col, int page){
+  int byte=0;
+
+  for(int bi=0;bi<8 && page*8+bi<image.TellHeight();bi++){
+    if((int)image(col,page*8+bi)->Green==0) //pixel is black RGB=(0,0,0)
+      byte |= (1<<bi);
+  }
+  return byte;
+}
+
+//--------------------------------------------------------------------------
+//Write the page bytes compressed with PackBits run length encoding.
+//A code of 0 to 127 is followed by code+1 literal bytes and a code of
+//129 to 255 is followed by one byte that is repeated 257-code times.
+//Repeats are used for runs of 3 or more bytes.
+//
+void savePackBits(ofstream &out, BMP &image){
+  vector<int> data, packed;
+  int n, i, run, start, pages;
+
+  pages=(image.TellHeight()+7)/8;
+  for(int j=0;j<pages;j++)
+    for(int col=0;col<image.TellWidth();col++)
+      data.push_back(pageByte(image,col,j));
+  n=data.size();
+
+  i=0;
+  while(i<n){
+    run=1;
+    while(i+run<n && run<128 && data[i+run]==data[i])
+      run++;
+    if(run>=3){
+      packed.push_back(257-run);
+      packed.push_back(data[i]);
+      i+=run;
+      continue;
+    }
+    start=i;
+    while(i<n && i-start<128){
+      if(i+2<n && data[i]==data[i+1] && data[i]==data[i+2])
+        break; //a run starts here
+      i++;
+    }
+    packed.push_back(i-start-1);
+    while(start<i)
+      packed.push_back(data[start++]);
+  }
+
+  if(verbose)
+    cout <<"packed "<< n <<" bytes of bitmap data into "<< packed.size() <<" bytes"<<endl;
+
+  for(i=0;i<(int)packed.size();i++){
+    out <<"0x";
+    if (packed[i]<16) out <<"0";
+    out<<hex<<packed[i]<<dec;
+    if(i+1<(int)packed.size()) out << ", ";
+    if((i+1)%WRITE_BYTES_PER_LINE==0) out<<endl;
+  }
+  out << endl;
+}
@@ -0,0 +1,90 @@
+/*
+  Arduino.h - host (PC) stand-in for the Arduino core header
+  
+  vi:ts=4
+
+  This file is part of the Arduino GLCD library.
+
+  GLCD is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 2.1 of the License, or
+  (at your option) any later version.
+
+  GLCD is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with GLCD.  If not, see <http://www.gnu.org/licenses/>.
+
+  This header provides just enough of the Arduino core for the glcd library
+  to build and run on a PC against the controller emulator in glcd_Emulator.cpp.
+  Time does not come from a real clock. It is the emulated bus time so
+  that micros() and millis() report what the code would take on the AVR.
+ 
+*/
+
+#ifndef GLCD_HOST_ARDUINO_H
+#define GLCD_HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <avr/pgmspace.h>
+#include "Print.h"
+#include "WString.h"
+
+#ifndef F_CPU
+#define F_CPU 16000000UL
+#endif
+
+#define HIGH	1
+#define LOW		0
+#define INPUT	0
+#define OUTPUT	1
+
+#ifndef _BV
+#define _BV(bit) (1 << (bit))
+#endif
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#ifndef min
+#define min(a,b) ((a)<(b)?(a):(b))
+#define max(a,b) ((a)>(b)?(a):(b))
+#endif
+
+unsigned long micros(void);
+unsigned long millis(void);
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+/*
+ * Serial output goes to stdout
+ */
+class HostSerial : public Print
+{
+  public:
+	void begin(unsigned long baud) { (void) baud; }
+	virtual size_t write(uint8_t c);
+};
+extern HostSerial Serial;
+
+/*
+ * random numbers use the C library so runs can be repeated with randomSeed()
+ */
+inline void randomSeed(unsigned int seed) { srand(seed); }
+inline long random(long howbig) { return(howbig ? rand() % howbig : 0); }
+inline long random(long howsmall, long howbig) { return(howsmall < howbig ? howsmall + random(howbig - howsmall) : howsmall); }
+
+inline int analogRead(uint8_t pin) { (void) pin; return(rand() & 0x3ff); }
+
+inline long map(long x, long in_min, long in_max, long out_min, long out_max)
+{
+	return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+#endif
@@ -0,0 +1,91 @@
+/*
+  Print.h - host (PC) stand-in for the Arduino Print base class
+  
+  vi:ts=4
+
+  This file is part of the Arduino GLCD library.
+
+  GLCD is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 2.1 of the License, or
+  (at your option) any later version.
+
+  GLCD is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with GLCD.  If not, see <http://www.gnu.org/licenses/>.
+
+  Only the parts of Print used by the glcd library and the host
+  programs are provided. Numbers are formatted with the C library.
+ 
+*/
+
+#ifndef GLCD_HOST_PRINT_H
+#define GLCD_HOST_PRINT_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "WString.h"
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+class Print
+{
+  public:
+	virtual size_t write(uint8_t) = 0;
+
+	size_t write(const char *str)
+	{
+	size_t n = 0;
+		while(*str)
+			n += write((uint8_t) *str++);
+		return(n);
+	}
+	size_t print(const char *str)				{ return(write(str)); }
+	size_t print(const String &str)				{ return(write(str.c_str())); }
+	size_t print(char c)						{ return(write((uint8_t) c)); }
+	size_t print(unsigned char n, int base = DEC)	{ return(print((unsigned long) n, base)); }
+	size_t print(int n, int base = DEC)			{ return(print((long) n, base)); }
+	size_t print(unsigned int n, int base = DEC)	{ return(print((unsigned long) n, base)); }
+	size_t print(long n, int base = DEC)
+	{
+		if(n < 0 && base == DEC)
+			return(print('-') + print((unsigned long) -n, base));
+		return(print((unsigned long) n, base));
+	}
+	size_t print(unsigned long n, int base = DEC)
+	{
+	char buf[8 * sizeof(long) + 1];
+	char *str = &buf[sizeof(buf) - 1];
+
+		if(base < 2)
+			base = 10;
+		*str = 0;
+		do
+		{
+			uint8_t digit = n % base;
+			*--str = digit < 10 ? '0' + digit : 'A' + digit - 10;
+			n /= base;
+		} while(n);
+		return(write(str));
+	}
+	size_t print(double n, int digits = 2)
+	{
+	char buf[32];
+		snprintf(buf, sizeof(buf), "%.*f", digits, n);
+		return(write(buf));
+	}
+
+	size_t println(void)						{ return(write('\n')); }
+	template<class T> size_t println(T arg)		{ return(print(arg) + println()); }
+	template<class T> size_t println(T arg, int base)	{ return(print(arg, base) + println()); }
+};
+
+#endif
@@ -0,0 +1,41 @@
+/*
+  WString.h - host (PC) stand-in for the Arduino String class
+  
+  vi:ts=4
+
+  This file is part of the Arduino GLCD library.
+
+  GLCD is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 2.1 of the License, or
+  (at your option) any later version.
+
+  GLCD is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with GLCD.  If not, see <http://www.gnu.org/licenses/>.
+
+  Only the parts of String used by the glcd library are provided.
+ 
+*/
+
+#ifndef GLCD_HOST_WSTRING_H
+#define GLCD_HOST_WSTRING_H
+
+#include <string.h>
+
+class String
+{
+  public:
+	String(const char *str = "") : buf(str) {}
+	unsigned int length(void) const { return(strlen(buf)); }
+	char operator [](unsigned int index) const { return(buf[index]); }
+	const char *c_str(void) const { return(buf); }
+  private:
+	const char *buf;
+};
+
+#endif
@@ -0,0 +1,36 @@
+/*
+  avr/interrupt.h - host (PC) stand-in for the AVR libc interrupt header
+  
+  vi:ts=4
+
+  This file is part of the Arduino GLCD library.
+
+  GLCD is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 2.1 of the License, or
+  (at your option) any later version.
+
+  GLCD is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with GLCD.  If not, see <http://www.gnu.org/licenses/>.
+
+  An interrupt handler is an ordinary function that the emulator calls.
+ 
+*/
+
+#ifndef GLCD_HOST_INTERRUPT_H
+#define GLCD_HOST_INTERRUPT_H
+
+#include "glcd_Emulator.h"
+
+#define ISR_NOBLOCK
+#define ISR(vector, ...)	extern "C" void vector(void); void vector(void)
+
+#define cli()	glcd_EmuCli()
+#define sei()	glcd_EmuSei()
+
+#endif
@@ -0,0 +1,47 @@
+/*
+  avr/pgmspace.h - host (PC) stand-in for the AVR libc program memory header
+  
+  vi:ts=4
+
+  This file is part of the Arduino GLCD library.
+
+  GLCD is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 2.1 of the License, or
+  (at your option) any later version.
+
+  GLCD is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with GLCD.  If not, see <http://www.gnu.org/licenses/>.
+
+  On a host build there is only one address space so "program memory"
+  is ordinary const data and the pgm read functions are simple dereferences.
+ 
+*/
+
+#ifndef GLCD_HOST_PGMSPACE_H
+#define GLCD_HOST_PGMSPACE_H
+
+#include <stdint.h>
+#include <string.h>
+
+#define PROGMEM
+#define PSTR(s)				(s)
+
+typedef const char *PGM_P;
+typedef char prog_char;
+typedef unsigned char prog_uchar;
+typedef uint8_t prog_uint8_t;
+typedef uint16_t prog_uint16_t;
+
+#define pgm_read_byte(addr)	(*(const uint8_t *)(addr))
+#define pgm_read_word(addr)	(*(const uint16_t *)(addr))
+
+#define strlen_P(s)			strlen(s)
+#define memcpy_P(d, s, n)	memcpy((d), (s), (n))
+
+#endif
@@ -0,0 +1,522 @@
+/*
+  glcd_Emulator.cpp - software model of the glcd controller chips for host (PC) builds
+  Copyright (c) 2010 Bill Perry
+
+  vi:ts=4
+
+  This file is part of the Arduino GLCD library.
+
+  GLCD is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 2.1 of the License, or
+  (at your option) any later version.
+
+  GLCD is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with GLCD.  If not, see <http://www.gnu.org/licenses/>.
+
+  The emulator is built with the same glcd_Config.h as the library so it
+  knows the pin assignments, chip selects and command set of the configured device.
+
+  The controller family is picked from the command set the device header defines:
+	LCD_SET_ADDLO			ks0713/st7565 style, 132 columns, 65 rows
+	LCD_SET_ADD == 0x40		ks0108 style, 64 columns, 64 rows, column wraps
+	otherwise				sed1520/mt12232d style, 80 columns, 32 rows
+
+  Bus timing is only an estimate of what a 16Mhz AVR would take:
+  each control pin change is 2 cycles, each 8 bit data bus operation is
+  4 cycles, and each busy flag poll is 4 cycles. The explicit delays the
+  library asks for are added as is.
+
+*/
+
+#include <string.h>
+#include "glcd_Config.h"
+#include "include/glcd_io.h"
+#include "glcd_Emulator.h"
+
+#if defined(LCD_SET_ADDLO)
+#define EMU_KS0713
+#define EMU_RAMCOLS		132
+#define EMU_LINES		64		// rows that are affected by the start line
+#define EMU_RAMROWS		65		// extra row is the icon row
+#ifndef GLCD_EMU_tBUSY
+#define GLCD_EMU_tBUSY	0
+#endif
+#elif LCD_SET_ADD == 0x40
+#define EMU_KS0108
+#define EMU_RAMCOLS		64
+#define EMU_LINES		64
+#define EMU_RAMROWS		64
+#ifndef GLCD_EMU_tBUSY
+#define GLCD_EMU_tBUSY	1500	// observed busy time after a ks0108 access
+#endif
+#else
+#define EMU_SED1520
+#define EMU_RAMCOLS		80
+#define EMU_LINES		32
+#define EMU_RAMROWS		32
+#ifndef GLCD_EMU_tBUSY
+#define GLCD_EMU_tBUSY	500
+#endif
+#endif
+
+#define EMU_RAMPAGES	((EMU_RAMROWS + 7)/8)
+
+#define EMU_tPIN		125		// ns for a control pin change
+#define EMU_tBUS		250		// ns for an 8 bit data bus operation
+#define EMU_tPOLL		250		// ns for one pass of the busy wait loop
+
+#define EMU_PINS		0x160	// covers arduino pin #s and avrio PIN_Pb values
+
+typedef struct {
+	uint8_t ram[EMU_RAMPAGES][EMU_RAMCOLS];
+	uint8_t page;
+	uint8_t col;
+	uint8_t startline;
+	uint8_t on;
+	uint8_t latch;		// read output register (what a read will return)
+	uint8_t rmw;		// in read-modify-write mode
+	uint8_t rmwcol;		// column to return to at end of rmw mode
+	uint8_t strobe;		// E currently active for this chip
+	uint8_t driving;	// chip is driving the data bus
+	uint8_t out;		// value being driven on the data bus
+	unsigned long long busy_until;
+} emuChip_t;
+
+static emuChip_t emuChip[glcd_CHIP_COUNT];
+static uint8_t emuPin[EMU_PINS];
+static uint8_t emuDataOut;
+static uint8_t emuEnActive = HIGH;
+static glcd_EmuStats_t emuStats;
+
+/*
+ * Timer interrupt model.
+ * The interrupt is taken at the first bus access or delay after
+ * each emulated millisecond, as long as interrupts are enabled.
+ */
+#define EMU_tTIMER		1024000UL	// ns between timer0 interrupts (16Mhz/64/256)
+
+static void (*emuTimerISR)(void);
+static unsigned long long emuTimerNext;
+static uint8_t emuIntrOff;		// interrupts disabled (nesting count)
+static uint8_t emuInISR;
+
+static void emuClock(unsigned long long ns)
+{
+	emuStats.ns += ns;
+	if(emuTimerISR && !emuIntrOff && !emuInISR && emuStats.ns >= emuTimerNext)
+	{
+		while(emuTimerNext <= emuStats.ns)	// missed ticks are lost like on the AVR
+			emuTimerNext += EMU_tTIMER;
+		emuInISR = 1;
+		emuTimerISR();
+		emuInISR = 0;
+	}
+}
+
+/*
+ * Chip select matching.
+ * These rip apart the chip select strings from the config file the
+ * same way the lcdChipSelect() macros in glcd_io.h do, but compare
+ * the pin levels instead of setting them.
+ */
+#define emuCsMatch1(p,v) (emuPin[p] == (v))
+#define emuCsMatch2(p1,v1, p2,v2) (emuCsMatch1(p1,v1) && emuCsMatch1(p2,v2))
+#define emuCsMatch3(p1,v1, p2,v2, p3,v3) (emuCsMatch2(p1,v1, p2,v2) && emuCsMatch1(p3,v3))
+#define emuCsMatch4(p1,v1, p2,v2, p3,v3, p4,v4) (emuCsMatch2(p1,v1, p2,v2) && emuCsMatch2(p3,v3, p4,v4))
+
+#if defined(glcdCSEL4)
+#define emuCsMatch(cselstr) emuCsMatch4(cselstr)
+#elif defined(glcdCSEL3)
+#define emuCsMatch(cselstr) emuCsMatch3(cselstr)
+#elif defined(glcdCSEL2)
+#define emuCsMatch(cselstr) emuCsMatch2(cselstr)
+#elif defined(glcdCSEL1)
+#define emuCsMatch(cselstr) emuCsMatch1(cselstr)
+#endif
+
+#ifndef glcdE1	// chips with their own enable pins are not selected
+static uint8_t emuChipSelected(uint8_t chip)
+{
+#ifdef glcd_CHIPALL
+	if(emuCsMatch(glcd_CHIPALL))
+		return(1);
+#endif
+#ifdef glcd_CHIP0
+#ifdef glcd_CHIP3
+	if(chip == 3) return(emuCsMatch(glcd_CHIP3));
+#endif
+#ifdef glcd_CHIP2
+	if(chip == 2) return(emuCsMatch(glcd_CHIP2));
+#endif
+#ifdef glcd_CHIP1
+	if(chip == 1) return(emuCsMatch(glcd_CHIP1));
+#endif
+	return(emuCsMatch(glcd_CHIP0));
+#else
+	return(1);
+#endif
+}
+#endif
+
+static uint8_t emuChipStrobe(uint8_t chip)
+{
+#if defined(glcdE1)
+	if(chip == 0)
+		return(emuPin[glcdE1] == HIGH);
+	return(emuPin[glcdE2] == HIGH);
+#else
+	return((emuPin[glcdEN] == emuEnActive) && emuChipSelected(chip));
+#endif
+}
+
+static uint8_t emuPinRW(void)
+{
+#ifdef glcdRW
+	return(emuPin[glcdRW]);
+#else
+	return(LOW);	// RW tied low
+#endif
+}
+
+static uint8_t emuInReset(void)
+{
+#ifdef glcdRES
+	return(emuPin[glcdRES] == LOW);
+#else
+	return(0);
+#endif
+}
+
+static void emuColInc(emuChip_t *cp)
+{
+#ifdef EMU_KS0108
+	cp->col = (cp->col + 1) & (EMU_RAMCOLS -1);	// 6 bit counter wraps
+#else
+	if(cp->col < EMU_RAMCOLS)	// counter stops at the end of RAM
+		cp->col++;
+#endif
+}
+
+static void emuCommand(emuChip_t *cp, uint8_t cmd)
+{
+#if defined(EMU_KS0108)
+	if((cmd & 0xc0) == 0x40)
+		cp->col = cmd & 0x3f;
+	else if((cmd & 0xf8) == 0xb8)
+		cp->page = cmd & 7;
+	else if((cmd & 0xc0) == 0xc0)
+		cp->startline = cmd & 0x3f;
+	else if((cmd & 0xfe) == 0x3e)
+		cp->on = cmd & 1;
+	else
+		emuStats.unknown++;
+#else
+	switch(cmd)
+	{
+		case 0xaf: cp->on = 1; return;
+		case 0xae: cp->on = 0; return;
+		case 0xe0: cp->rmw = 1; cp->rmwcol = cp->col; return;
+		case 0xee: cp->rmw = 0; cp->col = cp->rmwcol; return;
+		case 0xe2: cp->page = cp->col = cp->startline = cp->rmw = 0; return;
+		case 0xa0: case 0xa1: case 0xa4: case 0xa5: case 0xa8: case 0xa9:
+			return;	// ADC, static drive and duty don't change what the model tracks
+	}
+#if defined(EMU_KS0713)
+	if((cmd & 0xf0) == 0x00)
+		cp->col = (cp->col & 0xf0) | (cmd & 0x0f);
+	else if((cmd & 0xf0) == 0x10)
+		cp->col = (cp->col & 0x0f) | ((cmd & 0x0f) << 4);
+	else if((cmd & 0xc0) == 0x40)
+		cp->startline = cmd & 0x3f;
+	else if((cmd & 0xf0) == 0xb0)
+		cp->page = cmd & 0x0f;
+	else
+		emuStats.unknown++;
+#else
+	if(cmd < EMU_RAMCOLS)
+		cp->col = cmd;
+	else if((cmd & 0xfc) == 0xb8)
+		cp->page = cmd & 3;
+	else if((cmd & 0xe0) == 0xc0)
+		cp->startline = cmd & 0x1f;
+	else
+		emuStats.unknown++;
+#endif
+#endif
+	if(cp->page >= EMU_RAMPAGES)
+		cp->page = EMU_RAMPAGES -1;
+}
+
+/*
+ * E went active for the chip.
+ * Reads put data on the bus now.
+ */
+static uint8_t emuStrobeStart(emuChip_t *cp)
+{
+	if(emuPinRW() == LOW)
+		return(0);
+
+	cp->driving = 1;
+	if(emuPin[glcdDI] == LOW)
+	{
+		cp->out = 0;
+#ifdef LCD_RESET_FLAG
+		if(emuInReset())
+			cp->out |= LCD_RESET_FLAG;
+#endif
+		if(emuStats.ns < cp->busy_until)
+			cp->out |= LCD_BUSY_FLAG;
+		return(0);
+	}
+
+	if(emuStats.ns < cp->busy_until)
+		emuStats.busyhits++;
+
+	cp->out = cp->latch;
+	cp->latch = cp->col < EMU_RAMCOLS ? cp->ram[cp->page][cp->col] : 0;
+	if(!cp->rmw)
+		emuColInc(cp);
+	cp->busy_until = emuStats.ns + GLCD_EMU_tBUSY;
+	return(1);
+}
+
+/*
+ * E went inactive for the chip.
+ * Writes are latched on the trailing edge.
+ */
+static uint8_t emuStrobeEnd(emuChip_t *cp)
+{
+	if(cp->driving)
+	{
+		cp->driving = 0;
+		return(0);
+	}
+	if(emuPinRW() != LOW)
+		return(0);
+
+	if(emuStats.ns < cp->busy_until)
+		emuStats.busyhits++;
+
+	if(emuPin[glcdDI] == LOW)
+		emuCommand(cp, emuDataOut);
+	else
+	{
+		if(cp->col < EMU_RAMCOLS)
+			cp->ram[cp->page][cp->col] = emuDataOut;
+		emuColInc(cp);
+	}
+	cp->busy_until = emuStats.ns + GLCD_EMU_tBUSY;
+	return(emuPin[glcdDI] == LOW ? 1 : 2);
+}
+
+void glcd_EmuWritePin(uint16_t pin, uint8_t val)
+{
+uint8_t reads = 0, writes = 0;
+
+	emuClock(EMU_tPIN);
+	if(pin >= EMU_PINS)
+		return;
+	emuPin[pin] = val ? HIGH : LOW;
+
+	for(uint8_t chip = 0; chip < glcd_CHIP_COUNT; chip++)
+	{
+	emuChip_t *cp = &emuChip[chip];
+	uint8_t strobe = emuChipStrobe(chip);
+
+		if(strobe == cp->strobe)
+			continue;
+		cp->strobe = strobe;
+		if(strobe)
+			reads |= emuStrobeStart(cp);
+		else
+			writes |= emuStrobeEnd(cp);
+	}
+
+	/*
+	 * Count bus cycles rather than chips so that a write strobed
+	 * into several chips at once counts once.
+	 */
+	if(reads)
+		emuStats.dreads++;
+	if(writes & 1)
+		emuStats.cmds++;
+	if(writes & 2)
+		emuStats.dwrites++;
+}
+
+void glcd_EmuDataDir(uint8_t dirbits)
+{
+	emuClock(EMU_tBUS);
+}
+
+void glcd_EmuDataOut(uint8_t data)
+{
+	emuClock(EMU_tBUS);
+	emuDataOut = data;
+}
+
+uint8_t glcd_EmuDataIn(void)
+{
+uint8_t data = 0xff;	// pullups
+uint8_t drivers = 0;
+
+	emuClock(EMU_tBUS);
+	for(uint8_t chip = 0; chip < glcd_CHIP_COUNT; chip++)
+	{
+		if(emuChip[chip].driving)
+		{
+			data &= emuChip[chip].out;
+			drivers++;
+		}
+	}
+	if(drivers > 1)
+		emuStats.contention++;
+	else if(drivers && emuPin[glcdDI] == LOW)
+		emuStats.sreads++;
+	return(data);
+}
+
+/*
+ * The busy flag is live while E is active
+ * so each poll looks at the current bus time.
+ */
+uint8_t glcd_EmuRdBusystatus(void)
+{
+uint8_t busy = 0;
+
+	emuClock(EMU_tPOLL);
+	emuStats.polls++;
+	for(uint8_t chip = 0; chip < glcd_CHIP_COUNT; chip++)
+	{
+		if(emuChip[chip].driving && emuStats.ns < emuChip[chip].busy_until)
+			busy = 1;
+	}
+	return(busy);
+}
+
+void glcd_EmuDelay(unsigned long ns)
+{
+	emuClock(ns);
+}
+
+void glcd_EmuReset(void)
+{
+	emuTimerISR = 0;
+	emuIntrOff = 0;
+	memset(emuChip, 0, sizeof(emuChip));
+	memset(emuPin, 0, sizeof(emuPin));
+	memset(&emuStats, 0, sizeof(emuStats));
+	emuDataOut = 0;
+	emuEnActive = strcmp(glcd_DeviceName, "mt12232d") ? HIGH : LOW;
+#ifdef glcdEN
+	emuPin[glcdEN] = !emuEnActive;
+#endif
+}
+
+/*
+ * Return the pixel the panel shows at x,y
+ * taking the chip layout and display start line into account.
+ */
+uint8_t glcd_EmuPixel(uint8_t x, uint8_t y)
+{
+emuChip_t *cp;
+uint8_t col, row;
+
+	if(x >= DISPLAY_WIDTH || y >= DISPLAY_HEIGHT)
+		return(0);
+
+	cp = &emuChip[glcd_DevXYval2Chip(x, y)];
+	col = glcd_DevXval2ChipCol(x);
+	if(!cp->on || col >= EMU_RAMCOLS)
+		return(0);
+
+	row = y % CHIP_HEIGHT;
+	if(row < EMU_LINES)
+		row = (row + cp->startline) % EMU_LINES;
+	return((cp->ram[row/8][col] >> (row & 7)) & 1);
+}
+
+void glcd_EmuDump(FILE *fp)
+{
+	for(uint8_t y = 0; y < DISPLAY_HEIGHT; y++)
+	{
+		for(uint8_t x = 0; x < DISPLAY_WIDTH; x++)
+			fputc(glcd_EmuPixel(x, y) ? '#' : '.', fp);
+		fputc('\n', fp);
+	}
+}
+
+void glcd_EmuGetStats(glcd_EmuStats_t *stats)
+{
+	*stats = emuStats;
+}
+
+void glcd_EmuClearStats(void)
+{
+unsigned long long ns = emuStats.ns;
+
+	memset(&emuStats, 0, sizeof(emuStats));
+	emuStats.ns = ns;	// the clock keeps running
+}
+
+/*
+ * Arduino core timing functions run off the emulated bus clock.
+ */
+unsigned long micros(void)
+{
+	return((unsigned long) (emuStats.ns / 1000));
+}
+
+unsigned long millis(void)
+{
+	return((unsigned long) (emuStats.ns / 1000000));
+}
+
+void delay(unsigned long ms)
+{
+	emuClock((unsigned long long) ms * 1000000);
+}
+
+void delayMicroseconds(unsigned int us)
+{
+	emuClock((unsigned long long) us * 1000);
+}
+
+/*
+ * Serial output of host programs and sketches goes to stdout.
+ */
+HostSerial Serial;
+
+size_t HostSerial::write(uint8_t c)
+{
+	putchar(c);
+	return(1);
+}
+
+/*
+ * Timer interrupt and interrupt enable for the background flush
+ */
+void glcd_EmuTimerStart(void (*isr)(void))
+{
+	emuTimerISR = isr;
+	emuTimerNext = emuStats.ns + EMU_tTIMER;
+}
+
+uint8_t glcd_EmuCli(void)
+{
+	emuIntrOff++;
+	return(1);
+}
+
+uint8_t glcd_EmuSei(void)
+{
+	emuIntrOff--;
+	emuClock(EMU_tPIN);		// a pending interrupt is taken when interrupts are enabled
+	return(0);
+}
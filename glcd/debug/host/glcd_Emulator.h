@@ -0,0 +1,73 @@
+/*
+  glcd_Emulator.h - software model of the glcd controller chips for host (PC) builds
+  Copyright (c) 2010 Bill Perry
+
+  vi:ts=4
+
+  This file is part of the Arduino GLCD library.
+
+  GLCD is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 2.1 of the License, or
+  (at your option) any later version.
+
+  GLCD is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with GLCD.  If not, see <http://www.gnu.org/licenses/>.
+
+  The emulator sits underneath include/hostio.h and sees exactly the same
+  pin and data bus activity the AVR would drive onto a real module.
+  It models each chip of the configured device: page and column registers,
+  column auto increment, the read output latch (dummy read), busy status,
+  read-modify-write mode and the display start line.
+
+  The emulated bus also keeps a clock so that micros()/millis() on the host
+  return the time the same bus traffic would have taken on a 16Mhz AVR.
+
+*/
+
+#ifndef GLCD_EMULATOR_H
+#define GLCD_EMULATOR_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+/*
+ * Bus activity counters kept by the emulator.
+ * These are what the panel saw, not what the library thinks it did.
+ */
+typedef struct {
+	unsigned long cmds;			// command writes
+	unsigned long dwrites;		// data writes
+	unsigned long dreads;		// data reads (including dummy reads)
+	unsigned long sreads;		// status reads
+	unsigned long polls;		// busy flag polls
+	unsigned long busyhits;		// accesses while the chip was still busy
+	unsigned long contention;	// reads with more than one chip driving the bus
+	unsigned long unknown;		// commands the model did not recognize
+	unsigned long long ns;		// emulated bus time in nanoseconds
+} glcd_EmuStats_t;
+
+// bus side: called by the hostio.h primitives
+void glcd_EmuWritePin(uint16_t pin, uint8_t val);
+void glcd_EmuDataDir(uint8_t dirbits);
+void glcd_EmuDataOut(uint8_t data);
+uint8_t glcd_EmuDataIn(void);
+uint8_t glcd_EmuRdBusystatus(void);
+void glcd_EmuDelay(unsigned long ns);
+void glcd_EmuTimerStart(void (*isr)(void));
+uint8_t glcd_EmuCli(void);
+uint8_t glcd_EmuSei(void);
+
+// host side: used by host programs to look at the emulated panel
+void glcd_EmuReset(void);
+uint8_t glcd_EmuPixel(uint8_t x, uint8_t y);
+void glcd_EmuDump(FILE *fp);
+void glcd_EmuGetStats(glcd_EmuStats_t *stats);
+void glcd_EmuClearStats(void);
+
+#endif
@@ -0,0 +1,63 @@
+/*
+  glcd_HostMain.cpp - runs an Arduino sketch on a PC against the glcd emulator
+  
+  vi:ts=4
+
+  This file is part of the Arduino GLCD library.
+
+  GLCD is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 2.1 of the License, or
+  (at your option) any later version.
+
+  GLCD is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with GLCD.  If not, see <http://www.gnu.org/licenses/>.
+
+  usage: sketch [loops]
+
+  Calls setup() and then loop() the given number of times (default 1).
+  Serial output of the sketch goes to stdout.
+  Afterwards the emulated panel is drawn on stdout with '#' for dark pixels
+  and the bus activity and emulated bus time are reported on stderr.
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "Arduino.h"
+#include "glcd_Emulator.h"
+
+void setup(void);
+void loop(void);
+
+int main(int argc, char **argv)
+{
+int loops = argc > 1 ? atoi(argv[1]) : 1;
+glcd_EmuStats_t stats;
+
+	glcd_EmuReset();
+	setup();
+	while(loops-- > 0)
+		loop();
+
+	glcd_EmuDump(stdout);
+	fflush(stdout);
+
+	glcd_EmuGetStats(&stats);
+	fprintf(stderr, "commands %lu data writes %lu data reads %lu status reads %lu\n",
+		stats.cmds, stats.dwrites, stats.dreads, stats.sreads);
+	fprintf(stderr, "busy polls %lu busy violations %lu bus contention %lu unknown commands %lu\n",
+		stats.polls, stats.busyhits, stats.contention, stats.unknown);
+	fprintf(stderr, "bus time %.3fms\n", stats.ns / 1e6);
+
+	/*
+	 * Accessing a chip while it is busy or having two chips drive the bus
+	 * at once would be a bug on a real module.
+	 */
+	return(stats.busyhits || stats.contention ? 1 : 0);
+}
@@ -0,0 +1,33 @@
+/*
+  util/atomic.h - host (PC) stand-in for the AVR libc atomic block header
+  
+  vi:ts=4
+
+  This file is part of the Arduino GLCD library.
+
+  GLCD is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 2.1 of the License, or
+  (at your option) any later version.
+
+  GLCD is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with GLCD.  If not, see <http://www.gnu.org/licenses/>.
+
+  Atomic blocks hold off the emulated timer interrupt.
+ 
+*/
+
+#ifndef GLCD_HOST_ATOMIC_H
+#define GLCD_HOST_ATOMIC_H
+
+#include "glcd_Emulator.h"
+
+#define ATOMIC_RESTORESTATE
+#define ATOMIC_BLOCK(type)	for(uint8_t __todo = (glcd_EmuCli(), 1); __todo; __todo = (glcd_EmuSei(), 0))
+
+#endif
@@ -0,0 +1,194 @@
+/*
+ * GLCDbench
+ *
+ * Times a set of basic drawing operations and reports the results
+ * on the serial port (9600 baud) and on the glcd.
+ *
+ * It is intended to compare the performance of library build options
+ * on the same hardware. For example, build it once normally and once with
+ * GLCD_NOXCOL_SUPPORT defined in glcd_Config.h to see what
+ * tracking the hardware column of the glcd chips saves.
+ *
+ * When GLCD_STATS is defined in glcd_Config.h the glcd bus
+ * transactions of each test are also reported on the serial port.
+ * With GLCD_BUSY_PROFILE the busy wait histograms are reported as well,
+ * one line per chip and kind of access with the counts of waits of
+ * 0, 1, 2-3, 4-7, ... passes of the busy wait loop.
+ */
+
+#include <glcd.h>
+#include "fonts/SystemFont5x7.h"       // system font
+#include "bitmaps/ArduinoIcon.h"       // bitmap
+
+#define BENCH_LOOPS 4
+
+unsigned long bench[8];
+uint8_t benchCount;
+#ifdef GLCD_STATS
+glcdStats_t benchStats[8];
+#endif
+
+const char *benchNames[] = {
+	"text", "scroll", "lines", "dots", "rects", "bitmap"
+};
+
+void
+BenchStart(void)
+{
+	GLCD.ClearScreen();
+	GLCD.WaitFlush();
+#ifdef GLCD_STATS
+	GLCD.StatsBegin(&benchStats[benchCount]);
+#endif
+	bench[benchCount] = micros();
+}
+
+void
+BenchEnd(void)
+{
+	GLCD.WaitFlush();	// make sure write back modes have updated the display
+	bench[benchCount] = micros() - bench[benchCount];
+#ifdef GLCD_STATS
+	GLCD.StatsEnd(&benchStats[benchCount]);
+#endif
+	benchCount++;
+}
+
+void
+setup()
+{
+	Serial.begin(9600);
+	GLCD.Init();
+	GLCD.SelectFont(System5x7);
+}
+
+void
+loop()
+{
+uint8_t i, x, y;
+
+	benchCount = 0;
+
+	/*
+	 * sequential text, a full screen of characters
+	 */
+	BenchStart();
+	for(i = 0; i < BENCH_LOOPS; i++)
+	{
+		GLCD.CursorTo(0,0);
+		for(y = 0; y < GLCD.Height/8; y++)
+			GLCD.print("The quick brown fox jumps over");
+	}
+	BenchEnd();
+
+	/*
+	 * text that scrolls
+	 */
+	BenchStart();
+	for(i = 0; i < BENCH_LOOPS * 8; i++)
+	{
+		GLCD.print("scroll line ");
+		GLCD.println(i, DEC);
+	}
+	BenchEnd();
+
+	/*
+	 * lines at all angles
+	 */
+	BenchStart();
+	for(i = 0; i < BENCH_LOOPS; i++)
+	{
+		for(x = 0; x < GLCD.Width; x += 4)
+			GLCD.DrawLine(x, 0, GLCD.Width-1-x, GLCD.Height-1);
+		for(y = 0; y < GLCD.Height; y += 4)
+			GLCD.DrawLine(0, y, GLCD.Width-1, GLCD.Height-1-y, WHITE);
+	}
+	BenchEnd();
+
+	/*
+	 * individual pixels
+	 */
+	BenchStart();
+	for(i = 0; i < BENCH_LOOPS; i++)
+	{
+		for(y = 0; y < GLCD.Height; y += 3)
+			for(x = i; x < GLCD.Width; x += 5)
+				GLCD.SetDot(x, y, BLACK);
+	}
+	BenchEnd();
+
+	/*
+	 * filled rectangles not on page boundaries
+	 */
+	BenchStart();
+	for(i = 0; i < BENCH_LOOPS * 2; i++)
+	{
+		GLCD.FillRect(i, i+1, GLCD.Width-1-2*i, GLCD.Height-3-2*i, (i & 1) ? WHITE : BLACK);
+	}
+	BenchEnd();
+
+	/*
+	 * bitmaps
+	 */
+	BenchStart();
+	for(i = 0; i < BENCH_LOOPS * 4; i++)
+	{
+		GLCD.DrawBitmap(ArduinoIcon, i * 3, 0, (i & 1) ? WHITE : BLACK);
+	}
+	BenchEnd();
+
+	/*
+	 * report the results
+	 */
+	GLCD.ClearScreen();
+	for(i = 0; i < benchCount; i++)
+	{
+		GLCD.CursorTo(0, i);
+		GLCD.print(benchNames[i]);
+		GLCD.CursorTo(7);
+		GLCD.print(bench[i]);
+		GLCD.print("us");
+
+		Serial.print(benchNames[i]);
+		Serial.print('\t');
+		Serial.print(bench[i]);
+		Serial.println("us");
+#ifdef GLCD_STATS
+		for(uint8_t chip = 0; chip < glcd_CHIP_COUNT; chip++)
+		{
+			glcdChipStats_t *cs = &benchStats[i].chip[chip];
+
+			Serial.print("  chip ");
+			Serial.print(chip, DEC);
+			Serial.print(" cmds ");
+			Serial.print(cs->cmds);
+			Serial.print(" writes ");
+			Serial.print(cs->writes);
+			Serial.print(" reads ");
+			Serial.print(cs->reads);
+			Serial.print(" dummy ");
+			Serial.print(cs->dummyreads);
+			Serial.print(" polls ");
+			Serial.print(cs->polls);
+			Serial.print(" spins ");
+			Serial.print(cs->spins);
+			Serial.print(" gotoxy ");
+			Serial.println(cs->gotoxy);
+#ifdef GLCD_BUSY_PROFILE
+			for(uint8_t op = 0; op < GLCD_BUSY_OPS; op++)
+			{
+				Serial.print(op == GLCD_BUSY_CMD ? "    cmd  " : op == GLCD_BUSY_WRITE ? "    write" : "    read ");
+				for(uint8_t b = 0; b < GLCD_BUSY_BUCKETS; b++)
+				{
+					Serial.print(' ');
+					Serial.print(cs->busy[op][b]);
+				}
+				Serial.println();
+			}
+#endif
+		}
+#endif
+	}
+	Serial.println();
+	delay(5000);
+}
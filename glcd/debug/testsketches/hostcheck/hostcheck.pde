@@ -0,0 +1,551 @@
+/*
+ * hostcheck
+ *
+ * Drawing regression checks for the host build in debug/host:
+ *	cd debug/host; make SKETCH=../testsketches/hostcheck/hostcheck.pde LOOPS=3
+ *
+ * It is not intended to be run on an Arduino, it checks what the library
+ * draws by looking at the panel of the glcd emulator.
+ *
+ * Each check draws a random background and then the operation under test,
+ * both on the glcd and on a pixel model of the display kept here, then
+ * compares the emulated panel with the model. The checks are:
+ * - DrawBitmap() with the raster ops and StepDrawBitmap() and FillRect()
+ *   inside random clip areas
+ * - DrawBitmap() of PackBits compressed bitmaps against the same bitmaps uncompressed
+ * - sprites, compressed or not, moving over a background in a random sprite area
+ *
+ * Build options of glcd_Config.h are checked by building with them, eg.
+ *	make SKETCH=../testsketches/hostcheck/hostcheck.pde EXTRA="-DGLCD_WRITE_BACK -DGLCD_FLUSH_ISR"
+ * With GLCD_DOUBLE_BUFFER (which needs a config with a spare frame of glcd memory,
+ * like config/ks0108-128x32_Panel.h) each frame is shown with SwapBuffers() and
+ * the model keeps both frames, so the display must be left alone until the swap
+ * and then match what would have been drawn without double buffering.
+ *
+ * Each loop() runs every check with new random numbers. The counts of checks
+ * and failures are printed and the run fails if any check failed.
+ */
+
+#include <glcd.h>
+#include "bitmaps/ArduinoIcon.h"	// 64x64 bitmap
+#include "glcd_Emulator.h"
+
+#define BITMAP_CHECKS	100
+#define SPRITE_AREAS	8
+#define SPRITE_FRAMES	20
+#define SPRITES			6
+
+/*
+ * Pixel model of the frame being drawn and, with double buffering, the one shown
+ */
+uint8_t model[2][DISPLAY_HEIGHT][DISPLAY_WIDTH];
+uint8_t back;
+
+unsigned long checks, failures;
+uint8_t seed;
+
+/*
+ * Bitmaps in RAM, the host reads "program memory" like any other memory
+ */
+uint8_t bitmap[2 + 100*10];
+uint8_t packed[4 + 3*100*10];		// room for the worst case of pack()
+
+uint8_t tiny[] = { 12, 13,
+	0xff,0x81,0xa5,0x81,0x99,0x81,0xff,0x00,0x55,0xaa,0x55,0xaa,
+	0x1f,0x10,0x15,0x10,0x19,0x10,0x1f,0x00,0x05,0x0a,0x05,0x0a };
+uint8_t tinymask[] = { 12, 13,
+	0xff,0xff,0xff,0xff,0xff,0xff,0xff,0x00,0x0f,0xf0,0xff,0xff,
+	0x1f,0x1f,0x1f,0x1f,0x1f,0x1f,0x1f,0x00,0x0f,0x00,0x1f,0x1f };
+uint8_t odd[] = { 5, 3, 0x05, 0x02, 0x07, 0x01, 0x06 };
+uint8_t oddmask[] = { 5, 3, 0x07, 0x07, 0x07, 0x03, 0x06 };
+
+/*
+ * Sprite images: uncompressed and compressed images with their masks
+ */
+Image_t images[2][3];
+Image_t masks[2][3];
+uint8_t packedImages[3][4 + 3*64*8];
+uint8_t packedMasks[3][4 + 3*64*8];
+
+struct {
+	Image_t image, mask;
+	uint8_t x, y, z, shown;
+	unsigned long order;	// sprites of the same z are drawn in the order they got it
+} spriteModel[SPRITES];
+gSprite sprites[SPRITES];
+
+/*
+ * PackBits compress the data of a bitmap, with runs and literals
+ * of random lengths and the odd no-op code thrown in.
+ */
+uint16_t pack(const uint8_t *src, uint16_t len, uint8_t *dst)
+{
+uint16_t i = 0, o = 0, start, n, run;
+
+	while(i < len)
+	{
+		if(!random(20))
+			dst[o++] = 128;
+		for(run = 1; i + run < len && run < 128 && src[i + run] == src[i]; run++)
+			;
+		if(run >= 3 || (run == 2 && random(2)))
+		{
+			dst[o++] = 257 - run;
+			dst[o++] = src[i];
+			i += run;
+			continue;
+		}
+		n = random(2) ? 128 : random(5) + 1;
+		for(start = i; i < len && i - start < n; i++)
+		{
+			if(i > start && i + 2 < len && src[i] == src[i+1] && src[i] == src[i+2])
+				break;
+		}
+		dst[o++] = i - start - 1;
+		memcpy(dst + o, src + start, i - start);
+		o += i - start;
+	}
+	return(o);
+}
+
+Image_t packBitmap(Image_t bm, uint8_t *dst)
+{
+	dst[0] = 0;
+	dst[1] = GLCD_BITMAP_PACKBITS;
+	dst[2] = bm[0];
+	dst[3] = bm[1];
+	pack(bm + 2, bm[0] * ((bm[1] + 7) / 8), dst + 4);
+	return(dst);
+}
+
+uint8_t bitmapPixel(Image_t bm, int16_t x, int16_t y)
+{
+	return((bm[2 + (y/8) * bm[0] + x] >> (y & 7)) & 1);
+}
+
+int16_t signedCoord(uint8_t v, uint8_t size)
+{
+	return(v >= size ? v - 256 : v);
+}
+
+/*
+ * Show the frame drawn and check the panel against the model
+ */
+void check(const char *what)
+{
+uint16_t bad = 0;
+uint8_t x, y;
+
+	checks++;
+#ifdef GLCD_DOUBLE_BUFFER
+	for(x = 0; x < DISPLAY_WIDTH; x++)
+		for(y = 0; y < DISPLAY_HEIGHT; y++)
+			if(glcd_EmuPixel(x, y) != model[back ^ 1][y][x])
+				bad++;
+	if(bad)
+	{
+		Serial.print(what);
+		Serial.print(": frame shown changed before SwapBuffers(), ");
+		Serial.print(bad);
+		Serial.println(" pixels");
+		failures++;
+		bad = 0;
+	}
+	GLCD.SwapBuffers();
+#else
+	GLCD.WaitFlush();	// same as Flush() unless the flush is done in the background
+#endif
+
+	for(x = 0; x < DISPLAY_WIDTH; x++)
+		for(y = 0; y < DISPLAY_HEIGHT; y++)
+			if(glcd_EmuPixel(x, y) != model[back][y][x])
+				bad++;
+	if(bad)
+	{
+		if(failures < 10)
+		{
+			Serial.print(what);
+			Serial.print(": seed ");
+			Serial.print(seed);
+			Serial.print(", ");
+			Serial.print(bad);
+			Serial.println(" pixels wrong");
+		}
+		failures++;
+	}
+
+#ifdef GLCD_DOUBLE_BUFFER
+	back ^= 1;
+#endif
+}
+
+uint8_t rop(uint8_t op, uint8_t src, uint8_t pixel)
+{
+	switch(op)
+	{
+	  case GLCD_ROP_OR:
+		return(pixel | src);
+	  case GLCD_ROP_AND:
+		return(pixel & src);
+	  case GLCD_ROP_XOR:
+		return(pixel ^ src);
+	  case GLCD_ROP_ANDNOT:
+		return(pixel & !src);
+	}
+	return(src);
+}
+
+/*
+ * Model of FillRect(), x,y to x+width,y+height inclusive inside the clip area
+ */
+void modelFillRect(uint8_t x, uint8_t y, uint8_t width, uint8_t height, uint8_t color, uint8_t op,
+	uint8_t cx1, uint8_t cy1, uint8_t cx2, uint8_t cy2)
+{
+int16_t i, j;
+
+	for(i = x; i <= x + width && i < DISPLAY_WIDTH; i++)
+		for(j = y; j <= y + height && j < DISPLAY_HEIGHT; j++)
+			if(i >= cx1 && i <= cx2 && j >= cy1 && j <= cy2)
+				model[back][j][i] = rop(op, color == BLACK, model[back][j][i]);
+}
+
+/*
+ * Model of DrawBitmap() inside the clip area
+ */
+void modelBitmap(Image_t bm, uint8_t x, uint8_t y, uint8_t color, uint8_t op,
+	uint8_t cx1, uint8_t cy1, uint8_t cx2, uint8_t cy2)
+{
+int16_t i, j, px, py;
+
+	for(i = 0; i < bm[0]; i++)
+	{
+		px = signedCoord(x, DISPLAY_WIDTH) + i;
+		if(px < cx1 || px > cx2)
+			continue;
+		for(j = 0; j < bm[1]; j++)
+		{
+			py = signedCoord(y, DISPLAY_HEIGHT) + j;
+			if(py < cy1 || py > cy2)
+				continue;
+			model[back][py][px] = rop(op, bitmapPixel(bm, i, j) ^ (color == WHITE), model[back][py][px]);
+		}
+	}
+}
+
+void drawBackground(void)
+{
+uint8_t i, x, y, w, h, color;
+
+	GLCD.ClearScreen();
+	memset(model[back], 0, sizeof(model[back]));
+	for(i = 0; i < 20; i++)
+	{
+		x = random(DISPLAY_WIDTH);
+		y = random(DISPLAY_HEIGHT);
+		w = random(40);
+		h = random(20);
+		color = random(2) ? BLACK : WHITE;
+		GLCD.FillRect(x, y, w, h, color);
+		modelFillRect(x, y, w, h, color, GLCD_ROP_COPY, 0, 0, DISPLAY_WIDTH-1, DISPLAY_HEIGHT-1);
+	}
+}
+
+/*
+ * A random clip area, or the whole display
+ */
+void randomClip(uint8_t *clip)
+{
+uint8_t t;
+
+	clip[0] = 0;
+	clip[1] = 0;
+	clip[2] = DISPLAY_WIDTH-1;
+	clip[3] = DISPLAY_HEIGHT-1;
+	if(random(3))
+		return;
+	clip[0] = random(DISPLAY_WIDTH);
+	clip[1] = random(DISPLAY_HEIGHT);
+	clip[2] = random(DISPLAY_WIDTH);
+	clip[3] = random(DISPLAY_HEIGHT);
+	if(clip[0] > clip[2])
+	{
+		t = clip[0]; clip[0] = clip[2]; clip[2] = t;
+	}
+	if(clip[1] > clip[3])
+	{
+		t = clip[1]; clip[1] = clip[3]; clip[3] = t;
+	}
+}
+
+/*
+ * A random bitmap of random data, sparse data or long runs
+ */
+void randomBitmap(void)
+{
+uint8_t w, h, kind;
+uint16_t i;
+
+	w = random(100) + 1;
+	h = random(80) + 1;
+	kind = random(3);
+	bitmap[0] = w;
+	bitmap[1] = h;
+	for(i = 0; i < w * ((h + 7) / 8); i++)
+	{
+		if(kind == 0)
+			bitmap[2 + i] = random(256);
+		else if(kind == 1)
+			bitmap[2 + i] = random(8) ? 0 : random(256);
+		else
+			bitmap[2 + i] = (i / 7) * 13;
+	}
+	packBitmap(bitmap, packed);
+}
+
+void checkBitmaps(void)
+{
+uint8_t n, x, y, color, op, compressed;
+uint8_t clip[4];
+
+	for(n = 0; n < BITMAP_CHECKS; n++)
+	{
+		randomBitmap();
+		randomClip(clip);
+		x = random(DISPLAY_WIDTH + 40) - 20;
+		y = random(DISPLAY_HEIGHT + 40) - 20;
+		color = random(2) ? BLACK : WHITE;
+		op = random(3) ? GLCD_ROP_COPY : random(5);
+
+		for(compressed = 0; compressed < 2; compressed++)
+		{
+			drawBackground();
+			GLCD.SetClipArea(clip[0], clip[1], clip[2], clip[3]);
+			GLCD.DrawBitmap(compressed ? packed : bitmap, x, y, color, op);
+			GLCD.ResetClipArea();
+			modelBitmap(bitmap, x, y, color, op, clip[0], clip[1], clip[2], clip[3]);
+			check(compressed ? "DrawBitmap() compressed" : "DrawBitmap()");
+		}
+
+		drawBackground();
+		GLCD.SetClipArea(clip[0], clip[1], clip[2], clip[3]);
+		GLCD.StepDrawBitmap(random(2) ? packed : bitmap, x, y, color);
+		while(GLCD.Step(random(200)))
+			;
+		GLCD.ResetClipArea();
+		modelBitmap(bitmap, x, y, color, GLCD_ROP_COPY, clip[0], clip[1], clip[2], clip[3]);
+		check("StepDrawBitmap()");
+
+		drawBackground();
+		GLCD.SetClipArea(clip[0], clip[1], clip[2], clip[3]);
+		GLCD.FillRect(x, y, n % 50, n % 30, color, op);
+		GLCD.ResetClipArea();
+		if(x < DISPLAY_WIDTH && y < DISPLAY_HEIGHT)
+			modelFillRect(x, y, n % 50, n % 30, color, op, clip[0], clip[1], clip[2], clip[3]);
+		check("FillRect()");
+	}
+}
+
+/*
+ * Put the sprite area together in the model
+ */
+void modelSprites(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, Image_t background, uint8_t bgcolor)
+{
+uint8_t order[SPRITES];
+uint8_t i, k, t, px, py, m;
+int16_t sx, sy;
+
+	for(i = 0; i < SPRITES; i++)
+		order[i] = i;
+	for(i = 0; i < SPRITES; i++)
+		for(k = i + 1; k < SPRITES; k++)
+			if(spriteModel[order[i]].z > spriteModel[order[k]].z
+				|| (spriteModel[order[i]].z == spriteModel[order[k]].z
+					&& spriteModel[order[i]].order > spriteModel[order[k]].order))
+			{
+				t = order[i]; order[i] = order[k]; order[k] = t;
+			}
+
+	for(px = x1; px <= x2; px++)
+	{
+		for(py = y1; py <= y2; py++)
+		{
+			m = bgcolor == BLACK;
+			if(background && px - x1 < background[0] && py - y1 < background[1])
+				m ^= bitmapPixel(background, px - x1, py - y1);
+			for(i = 0; i < SPRITES; i++)
+			{
+				k = order[i];
+				if(!spriteModel[k].shown)
+					continue;
+				sx = px - signedCoord(spriteModel[k].x, DISPLAY_WIDTH);
+				sy = py - signedCoord(spriteModel[k].y, DISPLAY_HEIGHT);
+				if(sx < 0 || sy < 0 || sx >= spriteModel[k].image[0] || sy >= spriteModel[k].image[1])
+					continue;
+				if(spriteModel[k].mask ? bitmapPixel(spriteModel[k].mask, sx, sy) : bitmapPixel(spriteModel[k].image, sx, sy))
+					m = bitmapPixel(spriteModel[k].image, sx, sy);
+			}
+			model[back][py][px] = m;
+		}
+	}
+}
+
+/*
+ * Pick a new image for a sprite, the sprite is drawn with the compressed
+ * copy of the image or mask half the time. The model uses the uncompressed one.
+ */
+void spriteImage(uint8_t k)
+{
+uint8_t w, hasmask;
+
+	w = random(3);
+	hasmask = random(2);
+	spriteModel[k].image = images[0][w];
+	spriteModel[k].mask = hasmask ? masks[0][w] : 0;
+	sprites[k].SetImage(images[random(2)][w], hasmask ? masks[random(2)][w] : 0);
+}
+
+void checkSprites(void)
+{
+uint8_t n, frame, k, x1, y1, x2, y2, bgcolor, t;
+Image_t background;
+unsigned long order = 0;
+
+	for(n = 0; n < SPRITE_AREAS; n++)
+	{
+		x1 = random(DISPLAY_WIDTH);
+		y1 = random(DISPLAY_HEIGHT);
+		x2 = random(DISPLAY_WIDTH);
+		y2 = random(DISPLAY_HEIGHT);
+		if(!random(3))
+		{
+			x1 = y1 = 0;
+			x2 = DISPLAY_WIDTH-1;
+			y2 = DISPLAY_HEIGHT-1;
+		}
+		if(x1 > x2)
+		{
+			t = x1; x1 = x2; x2 = t;
+		}
+		if(y1 > y2)
+		{
+			t = y1; y1 = y2; y2 = t;
+		}
+
+		gSpriteArea area(x1, y1, x2, y2);
+		drawBackground();
+		check("sprite area background");
+
+		for(k = 0; k < SPRITES; k++)
+		{
+			spriteImage(k);
+			spriteModel[k].x = random(DISPLAY_WIDTH + 40) - 20;
+			spriteModel[k].y = random(DISPLAY_HEIGHT + 40) - 20;
+			spriteModel[k].z = random(3);
+			spriteModel[k].shown = 1;
+			spriteModel[k].order = order++;
+			sprites[k].MoveTo(spriteModel[k].x, spriteModel[k].y);
+			sprites[k].SetZ(spriteModel[k].z);
+			sprites[k].Show();
+			area.Add(sprites[k]);
+		}
+		background = random(3) ? images[0][0] : 0;
+		bgcolor = random(2) ? BLACK : WHITE;
+		area.SetBackground(background ? images[random(2)][0] : 0, bgcolor);
+
+		for(frame = 0; frame < SPRITE_FRAMES; frame++)
+		{
+			for(k = 0; k < SPRITES; k++)
+			{
+				switch(random(8))
+				{
+				  case 0: case 1: case 2:
+					spriteModel[k].x += random(5) - 2;
+					spriteModel[k].y += random(5) - 2;
+					sprites[k].MoveTo(spriteModel[k].x, spriteModel[k].y);
+					break;
+				  case 3:
+					spriteModel[k].x = random(DISPLAY_WIDTH + 40) - 20;
+					spriteModel[k].y = random(DISPLAY_HEIGHT + 40) - 20;
+					sprites[k].MoveTo(spriteModel[k].x, spriteModel[k].y);
+					break;
+				  case 4:
+					spriteModel[k].shown = random(2);
+					if(spriteModel[k].shown)
+						sprites[k].Show();
+					else
+						sprites[k].Hide();
+					break;
+				  case 5:
+					spriteModel[k].z = random(3);
+					spriteModel[k].order = order++;
+					sprites[k].SetZ(spriteModel[k].z);
+					break;
+				  case 6:
+					spriteImage(k);
+					break;
+				}
+			}
+#ifdef GLCD_DOUBLE_BUFFER
+			area.Redraw();	// the frame drawn on is two frames old
+#else
+			area.Update();
+#endif
+			modelSprites(x1, y1, x2, y2, background, bgcolor);
+			check("sprites");
+		}
+
+		for(k = 0; k < SPRITES; k++)
+		{
+			area.Remove(sprites[k]);
+			spriteModel[k].shown = 0;
+		}
+#ifdef GLCD_DOUBLE_BUFFER
+		area.Redraw();
+#endif
+		modelSprites(x1, y1, x2, y2, background, bgcolor);
+		check("sprites removed");
+	}
+}
+
+void setup()
+{
+uint8_t i;
+Image_t plain[3] = { ArduinoIcon, tiny, odd };
+Image_t plainmasks[3] = { ArduinoIcon, tinymask, oddmask };
+
+	GLCD.Init();
+	for(i = 0; i < 3; i++)
+	{
+		images[0][i] = plain[i];
+		images[1][i] = packBitmap(plain[i], packedImages[i]);
+		masks[0][i] = plainmasks[i];
+		masks[1][i] = packBitmap(plainmasks[i], packedMasks[i]);
+	}
+
+	/*
+	 * Start from a clear display, in both frames with double buffering
+	 */
+	GLCD.ClearScreen();
+	check("ClearScreen()");
+#ifdef GLCD_DOUBLE_BUFFER
+	GLCD.ClearScreen();
+	check("ClearScreen()");
+#endif
+}
+
+void loop()
+{
+	randomSeed(++seed);
+	checkBitmaps();
+	checkSprites();
+
+	Serial.print("seed ");
+	Serial.print(seed);
+	Serial.print(": ");
+	Serial.print(checks);
+	Serial.print(" checks, ");
+	Serial.print(failures);
+	Serial.println(" failed");
+	if(failures)
+		exit(1);
+}
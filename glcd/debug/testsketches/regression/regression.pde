@@ -38,8 +38,8 @@ void  loop()
 /*
  * A dummy function to simply check to see if all the API calls still compile
  * It is not intended to actually work or do anything useful.
- */
-
+ */
+
 uint8_t uint8var = 0;
 
 gText predefTA = gText(textAreaBOTTOM);
@@ -53,6 +53,15 @@ uint8_t uint8string[] = {'h', 'e', 'l', 'l', 'o', 0x81, 0x82, 0};
 char     charstring_P[] PROGMEM = {'h', 'e', 'l', 'l', 'o', 0x81, 0x82, 0};
 uint8_t uint8string_P[] PROGMEM = {'h', 'e', 'l', 'l', 'o', 0x81, 0x82, 0};
 
+uint8_t uint8buf[16];
+uint8_t points[] = {0,0, 20,0, 20,20, 0,20};
+uint8_t xbmbitmap[] PROGMEM = {8, 2, 0x81, 0x7e};
+
+gSpriteArea spritearea;
+gSpriteArea predefSA = gSpriteArea(0, 0, 63, 31);
+gSprite sprite;
+gSprite masksprite = gSprite(ArduinoIcon64x32, ArduinoIcon64x32, 1);
+
 void regression(void)
 {
 
@@ -60,38 +69,80 @@ void regression(void)
 	 * Control functions.
 	 */
 	GLCD.Init();
-	GLCD.SetDisplayMode(NON_INVERTED);
-
-	/*
-	 * Device layer functions.
-	 */
-
+	GLCD.SetDisplayMode(NON_INVERTED);
+
+	/*
+	 * Device layer functions.
+	 */
+
 	GLCD.GotoXY(0,0);
 	GLCD.GotoXY(uint8var, uint8var);
 	GLCD.SetDot(0,0, BLACK);
-	GLCD.SetDot(uint8var, uint8var, BLACK);
-	GLCD.SetPixels(0,0, 20,20, BLACK);
-	GLCD.SetPixels(uint8var, uint8var, uint8var, uint8var, BLACK);
-	uint8var = GLCD.ReadData();
-	GLCD.WriteData(0);
-	GLCD.WriteData(uint8var);
-
+	GLCD.SetDot(uint8var, uint8var, BLACK);
+	GLCD.SetPixels(0,0, 20,20, BLACK);
+	GLCD.SetPixels(uint8var, uint8var, uint8var, uint8var, BLACK);
+	uint8var = GLCD.ReadData();
+	GLCD.WriteData(0);
+	GLCD.WriteData(uint8var);
+	GLCD.WriteDataBlock(uint8buf, sizeof(uint8buf));
+	GLCD.WriteDataBlock(uint8buf, uint8var, WHITE);
+	GLCD.WriteDataBlock_P(uint8string_P, 5);
+	GLCD.ReadDataBlock(uint8buf, sizeof(uint8buf));
+	GLCD.Flush();
+	uint8var = GLCD.FlushStep(1);
+	GLCD.WaitFlush();
+	uint8var = GLCD.FlushPending();
+	uint8var = GLCD.FlushPeak();
+#ifdef GLCD_DOUBLE_BUFFER
+	GLCD.SwapBuffers();
+#endif
+
+	GLCD.SetClipArea(0,0, 63, 31);
+	GLCD.SetClipArea(uint8var, uint8var, uint8var, uint8var);
+	GLCD.ResetClipArea();
+
 	/*
 	 * Graphic Functions
 	 */
-	GLCD.ClearScreen(WHITE);
-	GLCD.ClearPage(0, WHITE);
-	GLCD.DrawVLine(0,1,2,BLACK);
+	GLCD.ClearScreen(WHITE);
+	GLCD.ClearPage(0, WHITE);
+	GLCD.DrawVLine(0,1,2,BLACK);
 	GLCD.DrawHLine(0,0, GLCD.Width, BLACK);
-	GLCD.DrawLine(0,0, GLCD.Right, GLCD.Bottom, BLACK);
+	GLCD.DrawLine(0,0, GLCD.Right, GLCD.Bottom, BLACK);
 	GLCD.DrawRect(0,0, 10, 10, BLACK);
-	GLCD.DrawRoundRect(0, 0, 10, 10, 1, BLACK);
-	GLCD.FillRect(0,0, 10, 10, BLACK);
-	GLCD.InvertRect(0,0, 10, 10);
-	GLCD.DrawCircle(GLCD.CenterX, GLCD.CenterY, 16, BLACK);	
+	GLCD.DrawRoundRect(0, 0, 10, 10, 1, BLACK);
+	GLCD.FillRect(0,0, 10, 10, BLACK);
+	GLCD.FillRect(0,0, 10, 10, BLACK, GLCD_ROP_XOR);
+	GLCD.InvertRect(0,0, 10, 10);
+	GLCD.DrawCircle(GLCD.CenterX, GLCD.CenterY, 16, BLACK);	
 	GLCD.FillCircle(GLCD.CenterX, GLCD.CenterY, 16, BLACK);	
+	GLCD.FillTriangle(0,0, 20,0, 10,20, BLACK);
+	GLCD.FillTriangle(0,0, 20,0, 10,20);
+	GLCD.FillPolygon(points, 4, BLACK);
+	GLCD.FillPolygon(points, sizeof(points)/2);
+
+	GLCD.DrawBitmap(ArduinoIcon64x32, 0, 0, BLACK);
+	GLCD.DrawBitmap(ArduinoIcon64x32, 0, 0, BLACK, GLCD_ROP_COPY);
+	GLCD.DrawBitmap(ArduinoIcon64x32, 0, 0, BLACK, GLCD_ROP_OR);
+	GLCD.DrawBitmap(ArduinoIcon64x32, 0, 0, BLACK, GLCD_ROP_AND);
+	GLCD.DrawBitmap(ArduinoIcon64x32, 0, 0, BLACK, GLCD_ROP_XOR);
+	GLCD.DrawBitmap(ArduinoIcon64x32, 0, 0, BLACK, GLCD_ROP_ANDNOT);
+	GLCD.DrawBitmapXBM(xbmbitmap, 0, 0, BLACK);
+	GLCD.DrawBitmapXBM(xbmbitmap, 0, 0);
+	GLCD.DrawBitmapXBM_P(8, 2, xbmbitmap+2, 0, 0, BLACK, WHITE);
 
-	GLCD.DrawBitmap(ArduinoIcon64x32, 0, 0, BLACK);
+	/*
+	 * Drawing a piece at a time
+	 */
+	GLCD.StepClearScreen();
+	GLCD.StepClearScreen(BLACK);
+	GLCD.StepFillRect(0,0, 10, 10, BLACK);
+	GLCD.StepDrawBitmap(ArduinoIcon64x32, 0, 0, BLACK);
+	GLCD.StepDrawString("dummy stepdrawstring string", 0, 0);
+	GLCD.StepDrawString_P(PSTR("dummy stepdrawstring_p string"), 0, 0);
+	while(GLCD.Step(100))
+		;
+	uint8var = GLCD.Step(0);
 	
 	/*
 	 * check text wrapper functions in GLCD
@@ -101,6 +152,8 @@ void regression(void)
 
 	GLCD.SetFontColor(BLACK); 		// new gText function
 	GLCD.SetFontColor(WHITE);		// new gText function
+	GLCD.SetFontRop(GLCD_ROP_COPY);
+	GLCD.SetFontRop(GLCD_ROP_XOR);
 	GLCD.SetTextMode(DEFAULT_SCROLLDIR);	// new gText function
 	GLCD.SetTextMode(SCROLL_UP);		// new gtext function
 	GLCD.SetTextMode(SCROLL_DOWN);		// new gText function
@@ -148,7 +201,7 @@ void regression(void)
 	/*
 	 * Deprecated GLCD functions
 	 */
-	GLCD.DrawVertLine(0,1,2,BLACK);
+	GLCD.DrawVertLine(0,1,2,BLACK);
 	GLCD.DrawHoriLine(0,0, GLCD.Width, BLACK);
 	GLCD.ClearSysTextLine(0);
 	GLCD.SetInverted(NON_INVERTED);
@@ -160,8 +213,8 @@ void regression(void)
 	/*
  	 * Text Area functions
 	 */
-	predefTA.DefineArea(0, 0, GLCD.Right, GLCD.Bottom, SCROLL_UP);
-	predefTA.DefineArea(0, 0, 10, 1, SystemFont5x7, SCROLL_UP);
+	predefTA.DefineArea(0, 0, GLCD.Right, GLCD.Bottom, SCROLL_UP);
+	predefTA.DefineArea(0, 0, 10, 1, SystemFont5x7, SCROLL_UP);
 	predefTA.DefineArea(textAreaTOP);
 
 	predefTA.SetTextMode(SCROLL_UP);
@@ -174,6 +227,7 @@ void regression(void)
 
 	predefTA.SetFontColor(BLACK);
 	predefTA.SetFontColor(WHITE);
+	predefTA.SetFontRop(GLCD_ROP_OR);
 
 	predefTA.PutChar('c');
 	predefTA.PutChar(0xfe);
@@ -216,6 +270,34 @@ void regression(void)
 	predefTA.EraseTextLine(eraseFULL_LINE);
 	predefTA.EraseTextLine(0);
 
+	predefTA.StepDrawString("dummy stepdrawstring string", 0, 0);
+	predefTA.StepDrawString_P(PSTR("dummy stepdrawstring_p string"), 0, 0);
+	uint8var = predefTA.Step(100);
+
+	/*
+	 * Sprite functions
+	 */
+	spritearea.DefineArea(0, 0, GLCD.Right, GLCD.Bottom);
+	spritearea.SetBackground(ArduinoIcon64x64);
+	spritearea.SetBackground(ArduinoIcon64x64, BLACK);
+	spritearea.SetBackground(0);
+	spritearea.Add(sprite);
+	spritearea.Add(masksprite);
+	predefSA.Add(sprite);
+
+	sprite.SetImage(ArduinoIcon64x32);
+	sprite.SetImage(ArduinoIcon64x32, ArduinoIcon64x32);
+	sprite.MoveTo(0,0);
+	sprite.MoveTo(uint8var, uint8var);
+	sprite.SetZ(2);
+	sprite.Hide();
+	sprite.Show();
+
+	spritearea.Update();
+	spritearea.Redraw();
+	spritearea.Remove(masksprite);
+	predefSA.Remove(sprite);
+
 #ifndef GLCD_NO_PRINTF
 	predefTA.Printf("%s", "hello world\n");
 
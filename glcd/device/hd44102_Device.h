@@ -55,6 +55,10 @@
 #define LCD_BUSY_FLAG		0x80 
 #define LCD_BUSY_BIT		7
 
+#ifndef GLCD_tBUSY
+#define GLCD_tBUSY		4000	// ns busy after an access (used in write only mode)
+#endif
+
 /*
  * Define primitives used by glcd_Device.cpp --------------------------------
  */
@@ -74,11 +74,27 @@
 #define LCD_DISP_START		0xC0
 #define LCD_SET_PAGE		0xB8
 
+/*
+ * Device capabilities ------------------------------------------------------
+ */
+
+#define glcd_DevLines		64	// RAM lines the display start line wraps around
+#define glcd_DevStartLine(line)	(LCD_DISP_START | (line))	// set display start line command
+
 /*
  * Status register bits/flags -----------------------------------------------
  */
 
 #define LCD_BUSY_BIT		7
+
+/*
+ * Busy time after an access, waited out instead of polling busy in write only mode.
+ * The ks0108 is busy for up to 3 cycles of its CL clock, 7.5us with the
+ * usual 400Khz clock. Panels with a slower clock need a larger value.
+ */
+#ifndef GLCD_tBUSY
+#define GLCD_tBUSY		7500	// ns
+#endif
 #define LCD_BUSY_FLAG		0x80 
 
 #define LCD_RESET_BIT		4
@@ -97,6 +113,16 @@
 #define glcd_DevENstrobeHi(chip) lcdfastWrite(glcdEN, 1)
 #define glcd_DevENstrobeLo(chip) lcdfastWrite(glcdEN, 0)
 
+/*
+ * Panels with a chip select pin for each chip can select all the chips
+ * at once when the config file defines glcd_CHIPALL.
+ */
+#ifdef glcd_CHIPALL
+#define glcd_DevSelectAll()		lcdChipSelect(glcd_CHIPALL)
+#define glcd_DevENstrobeAllHi()	lcdfastWrite(glcdEN, 1)
+#define glcd_DevENstrobeAllLo()	lcdfastWrite(glcdEN, 0)
+#endif
+
 /*
  * Convert X & Y coordinates to chip values
  * The macros below assume that chips are either
@@ -114,11 +140,17 @@
  * on the ks0108 are powers of 2
  */
 #if CHIP_HEIGHT < DISPLAY_HEIGHT
-#define glcd_DevXYval2Chip(x,y) ((x/CHIP_WIDTH) + ((y/CHIP_HEIGHT) * (DISPLAY_HEIGHT/CHIP_HEIGHT)))
+#define glcd_DevXYval2Chip(x,y) (((x)/CHIP_WIDTH) + (((y)/CHIP_HEIGHT) * (DISPLAY_HEIGHT/CHIP_HEIGHT)))
 #else
-#define glcd_DevXYval2Chip(x,y)		((x/CHIP_WIDTH))	
+#define glcd_DevXYval2Chip(x,y)		(((x)/CHIP_WIDTH))	
 #endif
 
 #define glcd_DevXval2ChipCol(x)		((x) % CHIP_WIDTH)
 
+/*
+ * Chip column after a data read or write at column col.
+ * The ks0108 column counter is 6 bits and wraps.
+ */
+#define glcd_DevColInc(col)			(((col) + 1) & 0x3f)
+
 #endif //GLCD_PANEL_DEVICE_H
@@ -63,6 +63,17 @@
 #define LCD_NORMALLCD		0xa6	// black dots on white backbround
 
 #define LCD_RESET			0xE2	// Reset command not signal reset
+#define LCD_RMW				0xE0	// start RMW mode
+#define LCD_RMW_END			0xEE	// end RMW mode
+
+/*
+ * Device capabilities ------------------------------------------------------
+ */
+
+#define glcd_DevRMWmode		1	// reads don't advance the column in RMW mode, writes do
+#ifndef GLCD_tBUSY
+#define GLCD_tBUSY		1000	// ns busy after an access (used in write only mode)
+#endif
 
 /*
  * Status register bits/flags -----------------------------------------------
@@ -97,12 +108,19 @@
 
 #define glcd_DevXval2ChipCol(x)	(x)	// no multi chip support yet
 
+/*
+ * Chip column after a data read or write at column col.
+ * The column counter stops at the end of the 132 columns of RAM,
+ * so past that the column is not known.
+ */
+#define glcd_DevColInc(col)			((col) < 131 ? (col) + 1 : -1)
+
 /*
  * Convert from chip column value to hi/lo address value
  * for LCD commands.
  */
 
-#define glcd_DevCol2addrlo(x)		(x & 0xf)	// lo nibble
-#define glcd_DevCol2addrhi(x)		(x & 0xf0)	// hi nibble
+#define glcd_DevCol2addrlo(x)		((x) & 0xf)	// lo nibble
+#define glcd_DevCol2addrhi(x)		(((x) >> 4) & 0xf)	// hi nibble
 
 #endif //GLCD_PANEL_DEVICE_H
@@ -67,6 +67,17 @@
 #define LCD_RMW				0xE0	// start RMW mode
 #define LCD_RMW_END			0xEE	// end RMW mode
 
+/*
+ * Device capabilities ------------------------------------------------------
+ */
+
+#define glcd_DevRMWmode		1	// reads don't advance the column in RMW mode, writes do
+#define glcd_DevLines		32	// RAM lines the display start line wraps around
+#define glcd_DevStartLine(line)	(LCD_DISP_START | (line))	// set display start line command
+#ifndef GLCD_tBUSY
+#define GLCD_tBUSY		2000	// ns busy after an access (used in write only mode)
+#endif
+
 /*
  * Status register bits/flags -----------------------------------------------
  */
@@ -127,6 +138,13 @@
 
 #define glcd_DevXval2ChipCol(x)		((x) < CHIP_WIDTH ? (x + 0x13) : (x - CHIP_WIDTH))
 
+/*
+ * Chip column after a data read or write at column col.
+ * The column counter stops at the end of the 80 columns of RAM,
+ * so past that the column is not known.
+ */
+#define glcd_DevColInc(col)			((col) < 79 ? (col) + 1 : -1)
+
 /*
  * Custom init routine
  * This module is VERY funky!
@@ -63,6 +63,19 @@
 #define LCD_STATICDRIVE_ON	0xA5	// static drive all segments lit (power save)
 #define LCD_DUTY_16			0xA8	// 1/16 duty factor for driving LCD cells
 #define LCD_DUTY_32			0xA9	// 1/32 duty factor for driving LCD cells
+#define LCD_RMW				0xE0	// start RMW mode
+#define LCD_RMW_END			0xEE	// end RMW mode
+
+/*
+ * Device capabilities ------------------------------------------------------
+ */
+
+#define glcd_DevRMWmode		1	// reads don't advance the column in RMW mode, writes do
+#define glcd_DevLines		32	// RAM lines the display start line wraps around
+#define glcd_DevStartLine(line)	(LCD_DISP_START | (line))	// set display start line command
+#ifndef GLCD_tBUSY
+#define GLCD_tBUSY		2000	// ns busy after an access (used in write only mode)
+#endif
 
 /*
  * Status register bits/flags -----------------------------------------------
@@ -110,10 +123,28 @@ do									\
 {									\
 	if(chip == 0)					\
 	   lcdfastWrite(glcdE1, LOW);	\
-	else							\ 
+	else							\
 	   lcdfastWrite(glcdE2, LOW);	\
 }while(0)
 
+/*
+ * Both chips can be strobed at once to write them in parallel
+ */
+#define glcd_DevSelectAll()
+#define glcd_DevENstrobeAllHi() 	\
+do									\
+{									\
+	lcdfastWrite(glcdE1, HIGH);		\
+	lcdfastWrite(glcdE2, HIGH);		\
+}while(0)
+
+#define glcd_DevENstrobeAllLo() 	\
+do									\
+{									\
+	lcdfastWrite(glcdE1, LOW);		\
+	lcdfastWrite(glcdE2, LOW);		\
+}while(0)
+
 /*
  * Convert X & Y coordinate to chip values
  */
@@ -126,4 +157,11 @@ do									\
 
 #define glcd_DevXval2ChipCol(x)		((x) < CHIP_WIDTH ? x : (x - CHIP_WIDTH))
 
+/*
+ * Chip column after a data read or write at column col.
+ * The column counter stops at the end of the 80 columns of RAM,
+ * so past that the column is not known.
+ */
+#define glcd_DevColInc(col)			((col) < 79 ? (col) + 1 : -1)
+
 #endif //GLCD_PANEL_DEVICE_H
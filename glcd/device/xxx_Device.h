@@ -16,8 +16,13 @@ The following lcd primitives must be defined
 
 	For devices that split set column into to 2 commands of hi/lo: 
 
-	glcd_DevCol2addrlo(x)		(x & 0xf)	// lo nibble
-	glcd_DevCol2addrhi(x)		(x & 0xf0)	// hi nibble
+	glcd_DevCol2addrlo(x)		((x) & 0xf)			// lo nibble
+	glcd_DevCol2addrhi(x)		(((x) >> 4) & 0xf)	// hi nibble
+
+	Optionally, to let the library track the hardware column:
+
+	glcd_DevColInc(col)		// chip column after a data read/write at col
+							// (-1 if it is unknown)
   
 */
 
@@ -80,6 +85,8 @@ The following lcd primitives must be defined
 #define LCD_BUSY_FLAG
 #define LCD_BUSY_BIT
 
+#define GLCD_tBUSY	// ns the chip can stay busy after an access (used in write only mode)
+
 
 
 /*
@@ -113,4 +120,10 @@ The following lcd primitives must be defined
 #define glcd_DevCol2addrlo(x)
 #define glcd_DevCol2addrhi(x)
 
+/*
+ * Chip column after a data read or write at column col
+ * (If known)
+ */
+#define glcd_DevColInc(col)
+
 #endif //GLCD_PANEL_DEVICE_H
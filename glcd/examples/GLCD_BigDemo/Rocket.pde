@@ -51,11 +51,6 @@ byte brightness = 64;
 #define enemy1X tracker[3][1]
 #define enemy1Y tracker[4][2]
 
-#define playerXOld trackerOld[0][1]
-#define playerYOld trackerOld[0][2]
-#define enemy1XOld trackerOld[3][1]
-#define enemy1YOld trackerOld[4][2]
-
 char lives = 2;
 char score = 0;
 char level = 0;
@@ -67,24 +62,25 @@ long speedMillis[] = {0, 0, 0, 0, 0, 0};
 char tracker[8][5] = {
 // Bitmap,  Xpos,   Ypos,          Speed
   {PLAYER,  15,     32,            0}  ,
-  {ROCK2,   119,    random(0, 56), random(25, 75)}  ,
-  {ROCK5,   119,    random(0, 56), random(25, 75)}  ,
-  {ROCK8,   119,    random(0, 56), random(25, 75)}  ,
-  {ROCK1,   119,    random(0, 56), random(25, 75)}  ,
-  {ROCK3,   119,    random(0, 56), random(25, 75)}  ,
-  {BONUS,   119,    random(0, 56), random(25, 75)}
+  {ROCK2,   119,    random(8, 49), random(25, 75)}  ,
+  {ROCK5,   119,    random(8, 49), random(25, 75)}  ,
+  {ROCK8,   119,    random(8, 49), random(25, 75)}  ,
+  {ROCK1,   119,    random(8, 49), random(25, 75)}  ,
+  {ROCK3,   119,    random(8, 49), random(25, 75)}  ,
+  {BONUS,   119,    random(8, 49), random(25, 75)}
 };
 
-char trackerOld[8][5] = {
-// Bitmap,  Xpos,   Ypos,          Speed
-  {PLAYER,  15,     32,            0}  ,
-  {ROCK2,   119,    random(0, 56), random(25, 75)}  ,
-  {ROCK5,   119,    random(0, 56), random(25, 75)}  ,
-  {ROCK8,   119,    random(0, 56), random(25, 75)}  ,
-  {ROCK1,   119,    random(0, 56), random(25, 75)}  ,
-  {ROCK3,   119,    random(0, 56), random(25, 75)}  ,
-  {BONUS,   119,    random(0, 56), random(25, 75)}
-};
+/*
+ * The player and the rocks are sprites moving over the play field.
+ * Each frame the field is updated, which redraws just
+ * where the sprites were and where they are now.
+ * The field is the rows between the lives at the top and the
+ * score at the bottom, which are drawn outside it, so the
+ * sprites are kept at y 8 to 48.
+ */
+gSpriteArea field(0, 8, DISPLAY_WIDTH-1, 55);
+gSprite playerSprite(player);
+gSprite rockSprite[6];
 
 void rocket(int duration)
 {
@@ -98,6 +94,10 @@ void rocket(int duration)
   GLCD.DrawBitmap(startup, 0, 0, BLACK);
   delay(2000);
   GLCD.ClearScreen();
+  field.Add(playerSprite);
+  for(byte i = 0; i < 6; i++)
+    field.Add(rockSprite[i]);
+  field.Redraw();
   for(unsigned long start = millis();  millis() - start < duration; )
   {
     mainLoop();
@@ -153,21 +153,21 @@ void drawScore(){
 */
 void getControls(){
 #ifdef potPin
-  playerY = map(analogRead(potPin), 0, 1023, 0, 56);
+  playerY = map(analogRead(potPin), 0, 1023, 8, 48);
 #else
 /*
  * Not pot input so move the rocket up and down
  */
-static uint8_t yval;
+static uint8_t yval = 8;
 static uint8_t iter = 0;
 static int8_t dir = 1;
   if(++iter == 0)
     yval += dir;
 
-  if(yval == 0)
+  if(yval == 8)
     dir = 1;
 
-  if(yval == 56)
+  if(yval == 48)
     dir = -1;
   playerY = yval;
 #endif
@@ -201,7 +201,7 @@ void updatePos(int entity){
         
         tracker[entity][0] = random(1, 8);   // bitmap
         tracker[entity][1] = 119;            // start point
-        tracker[entity][2] = random(8, 56);  // height
+        tracker[entity][2] = random(8, 49);  // height
         tracker[entity][3] = random(fastSpeed, 100-level); // speed
       }  
   }
@@ -248,6 +248,7 @@ void BLOWUP(){
     level = 0;
   }
   resetTracker();
+  field.Redraw();
 }
 
 
@@ -260,12 +261,12 @@ void BLOWUP(){
 void resetTracker(){
   char trackerReset[8][5] = {
   {PLAYER, 15, 32, 0}  ,
-  {ROCK2,   119, random(0, 56), random(25, 75)}  ,
-  {ROCK5,   119, random(0, 56), random(25, 75)}  ,
-  {ROCK8,   119, random(0, 56), random(25, 75)}  ,
-  {ROCK1,   119, random(0, 56), random(25, 75)}  ,
-  {ROCK3,   119, random(0, 56), random(25, 75)}  ,
-  {BONUS,   119, random(0, 56), random(25, 75)}
+  {ROCK2,   119, random(8, 49), random(25, 75)}  ,
+  {ROCK5,   119, random(8, 49), random(25, 75)}  ,
+  {ROCK8,   119, random(8, 49), random(25, 75)}  ,
+  {ROCK1,   119, random(8, 49), random(25, 75)}  ,
+  {ROCK3,   119, random(8, 49), random(25, 75)}  ,
+  {BONUS,   119, random(8, 49), random(25, 75)}
   };
   
   for(byte entity = 0; entity <= 6; entity++){
@@ -327,35 +328,11 @@ void explosionAnim(char xPos, char yPos){
 void drawFrame(){
   for(int i=1; i<=rockAmount; i++){
     updatePos(i);
-    drawRock(i);
-  }
-  if(playerY != playerYOld){
-    GLCD.FillRect(playerXOld, playerYOld, 10, 8, WHITE);
-    GLCD.DrawBitmap(player, playerX, playerY, BLACK);
-  }
-
-  for(byte entity = 0; entity <= 6; entity++){
-    for(byte data = 0; data <= 3; data++){
-      trackerOld[entity][data] = tracker[entity][data];
-    }
-  }
-}
-
-
-/*
-******************************
-*  Draw rocks, way too much  *
-*  code...                   *
-******************************
-*/
-void drawRock(char entity){
-// Rock bitmaps really need to be in a 2D array, will cut down on the below
-  
-  if(tracker[entity][1] != trackerOld[entity][1]){
-
-    GLCD.FillRect(trackerOld[entity][1], trackerOld[entity][2], 12, 8, WHITE);
-    GLCD.DrawBitmap(rocks[tracker[entity][0]], tracker[entity][1], tracker[entity][2], BLACK);
+    rockSprite[i-1].SetImage(rocks[tracker[i][0]]);
+    rockSprite[i-1].MoveTo(tracker[i][1], tracker[i][2]);
   }
+  playerSprite.MoveTo(playerX, playerY);
+  field.Update();
 }
 
 #ifdef speakerAPin
@@ -0,0 +1,645 @@
+/*
+  gSprite.cpp - Support for sprites moving over a background on a graphical device
+  Copyright (c) 2026  GLCD library contributors
+
+  vi:ts=4
+
+  This file is part of the Arduino GLCD library.
+
+  GLCD is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 2.1 of the License, or
+  (at your option) any later version.
+
+  GLCD is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with GLCD.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include <avr/pgmspace.h>
+#include "glcd.h"
+
+/*
+ * Start the decoders of the top and bottom bitmap pages of a page of
+ * the display when bitmap is compressed.
+ * Returns the decoders, or 0 for a bitmap that isn't compressed.
+ */
+static unpackState_t *gSprite_Unpack(Image_t bitmap, unpackState_t *unpack)
+{
+	if(!bitmap || ReadPgmData(bitmap))
+		return(0);
+	glcd_UnpackStart(&unpack[0], bitmap + 4);
+	unpack[1] = unpack[0];
+	return(unpack);
+}
+
+/*
+ * Get the byte at offset pos of the data of a glcd bitmap.
+ * The data of a compressed bitmap comes from the decoder, which
+ * only goes ahead, so the bytes must be asked for in order.
+ */
+static uint8_t gSprite_DataByte(Image_t bitmap, unpackState_t *unpack, uint16_t pos)
+{
+	if(!unpack)
+		return(ReadPgmData(bitmap + 2 + pos));
+	glcd_UnpackSeek(unpack, pos);
+	return(glcd_UnpackByte(unpack));
+}
+
+/*
+ * Get the byte of column col of a glcd bitmap that lands in a display page
+ * whose top row is row rows below the top of the bitmap.
+ * Rows of the page that are above or below the bitmap are 0.
+ * unpack is from gSprite_Unpack(), the first decoder gives the bitmap page at the
+ * top of the display page and the second the one at the bottom.
+ */
+static uint8_t gSprite_BitmapByte(Image_t bitmap, unpackState_t *unpack,
+	uint8_t width, uint8_t height, uint8_t col, int16_t row)
+{
+uint8_t data, shift;
+
+	if(row <= -8 || row >= height)
+		return(0);
+
+	if(row < 0)
+		data = gSprite_DataByte(bitmap, unpack ? &unpack[1] : 0, col) << -row;
+	else
+	{
+		shift = row & 7;
+		data = gSprite_DataByte(bitmap, unpack, (row/8) * width + col) >> shift;
+		if(shift && (row/8+1)*8 < height)
+			data |= gSprite_DataByte(bitmap, unpack ? &unpack[1] : 0, (row/8+1) * width + col) << (8 - shift);
+	}
+	if(height - row < 8)
+		data &= 0xff >> (8 - (height - row));
+	return(data);
+}
+
+/*
+ * Grow rect to cover add as well
+ */
+static void gSprite_MergeRect(spriteRect_t *rect, spriteRect_t *add)
+{
+	if(add->x1 < rect->x1)
+		rect->x1 = add->x1;
+	if(add->x2 > rect->x2)
+		rect->x2 = add->x2;
+	if(add->p1 < rect->p1)
+		rect->p1 = add->p1;
+	if(add->p2 > rect->p2)
+		rect->p2 = add->p2;
+}
+
+/*
+ * Add an area to be redrawn to the count areas in rects.
+ * Areas that overlap or touch are merged into one area covering both.
+ * When all GLCD_SPRITE_RECTS are in use, the last one is merged
+ * with it regardless.
+ * Returns the new count.
+ */
+static uint8_t gSprite_AddRect(spriteRect_t *rects, uint8_t count, spriteRect_t *add)
+{
+spriteRect_t rect = *add;
+spriteRect_t *r;
+uint8_t i;
+
+	for(i = 0; i < count; )
+	{
+		r = &rects[i];
+		if(rect.x1 <= r->x2 + 1 && r->x1 <= rect.x2 + 1 && rect.p1 <= r->p2 + 1 && r->p1 <= rect.p2 + 1)
+		{
+			gSprite_MergeRect(&rect, r);
+			*r = rects[--count];
+			i = 0;	// the bigger area can overlap ones already passed
+		}
+		else
+			i++;
+	}
+	if(count == GLCD_SPRITE_RECTS)
+		gSprite_MergeRect(&rect, &rects[--count]);
+	rects[count++] = rect;
+	return(count);
+}
+
+// This constructor creates a sprite without an image
+gSprite::gSprite()
+{
+	this->Image = 0;
+	this->Mask = 0;
+	this->X = 0;
+	this->Y = 0;
+	this->Z = 0;
+	this->Flags = GSPRITE_SHOWN;
+	this->Next = 0;
+	this->Area = 0;
+}
+
+/**
+ * Create a sprite
+ *
+ * @param image glcd bitmap of the sprite in program memory
+ * @param mask glcd bitmap of the pixels the sprite covers, 0 for the pixels set in image
+ * @param z the z order, sprites with a higher z are drawn over those with a lower z
+ *
+ * The sprite is at 0,0 and shown, but is not drawn until it is added
+ * to a sprite area with gSpriteArea::Add().
+ *
+ * @see SetImage()
+ */
+gSprite::gSprite(Image_t image, Image_t mask, uint8_t z)
+{
+	this->Image = image;
+	this->Mask = mask;
+	this->X = 0;
+	this->Y = 0;
+	this->Z = z;
+	this->Flags = GSPRITE_SHOWN;
+	this->Next = 0;
+	this->Area = 0;
+}
+
+/**
+ * Change the image of a sprite
+ *
+ * @param image glcd bitmap of the sprite in program memory
+ * @param mask glcd bitmap of the pixels the sprite covers, 0 for the pixels set in image
+ *
+ * The mask is the same width and height as the image. Where the mask has a pixel set,
+ * the sprite pixel replaces the one under it, elsewhere the sprite is transparent.
+ * Without a mask the sprite is transparent where the image pixels are clear.
+ *
+ * Changing the image is how a sprite is animated, the new frame
+ * is drawn by the next gSpriteArea::Update().
+ *
+ * The image and mask can be compressed bitmaps.
+ *
+ * @see MoveTo()
+ */
+void gSprite::SetImage(Image_t image, Image_t mask)
+{
+	if(this->Image != image || this->Mask != mask)
+	{
+		this->Image = image;
+		this->Mask = mask;
+		this->Flags |= GSPRITE_DIRTY;
+	}
+}
+
+/**
+ * Move a sprite
+ *
+ * @param x the x coordinate of the upper left corner of the sprite
+ * @param y the y coordinate of the upper left corner of the sprite
+ *
+ * Like DrawBitmap() coordinates past the right or bottom of the display
+ * wrap around, so a sprite can move off the left or top of the display.
+ * The parts of a sprite outside its sprite area are not drawn.
+ *
+ * The sprite is redrawn in its new place by the next gSpriteArea::Update().
+ */
+void gSprite::MoveTo(uint8_t x, uint8_t y)
+{
+	if(this->X != x || this->Y != y)
+	{
+		this->X = x;
+		this->Y = y;
+		this->Flags |= GSPRITE_DIRTY;
+	}
+}
+
+/**
+ * Change the z order of a sprite
+ *
+ * @param z the z order, sprites with a higher z are drawn over those with a lower z
+ *
+ * Sprites with the same z are drawn in the order they were
+ * added to their area, or last had their z changed, so the
+ * sprite is put over any others with the same z.
+ */
+void gSprite::SetZ(uint8_t z)
+{
+	this->Z = z;
+	if(this->Area)
+	{
+		this->Area->Unlink(this);
+		this->Area->Link(this);
+	}
+	this->Flags |= GSPRITE_DIRTY;
+}
+
+/**
+ * Show a sprite
+ *
+ * The sprite is drawn by the next gSpriteArea::Update().
+ *
+ * @see Hide()
+ */
+void gSprite::Show(void)
+{
+	if(!(this->Flags & GSPRITE_SHOWN))
+		this->Flags |= GSPRITE_SHOWN | GSPRITE_DIRTY;
+}
+
+/**
+ * Hide a sprite
+ *
+ * The sprite is erased by the next gSpriteArea::Update().
+ * A hidden sprite keeps its place in its sprite area.
+ *
+ * @see Show()
+ */
+void gSprite::Hide(void)
+{
+	if(this->Flags & GSPRITE_SHOWN)
+	{
+		this->Flags &= ~GSPRITE_SHOWN;
+		this->Flags |= GSPRITE_DIRTY;
+	}
+}
+
+// This constructor creates a sprite area using the entire display
+gSpriteArea::gSpriteArea()
+{
+	this->Sprites = 0;
+	this->Background = 0;
+	this->BgColor = WHITE;
+	this->DefineArea(0, 0, DISPLAY_WIDTH -1, DISPLAY_HEIGHT -1);
+}
+
+// This constructor creates a sprite area with the given coordinates
+// full display area is used if any coordinate is invalid
+gSpriteArea::gSpriteArea(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2)
+{
+	this->Sprites = 0;
+	this->Background = 0;
+	this->BgColor = WHITE;
+	this->DefineArea(x1, y1, x2, y2);
+}
+
+/**
+ * Define the area of the display the sprites are in
+ *
+ * @param x1 X coordinate of upper left corner
+ * @param y1 Y coordinate of upper left corner
+ * @param x2 X coordinate of lower right corner
+ * @param y2 Y coordinate of lower right corner
+ *
+ * The sprites of the area are drawn only inside it, and the
+ * background is drawn with its upper left corner at x1,y1.
+ * The entire display is used if any coordinate is invalid.
+ *
+ * Nothing is drawn, use Redraw() to draw the area.
+ *
+ * @see SetBackground()
+ */
+void gSpriteArea::DefineArea(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2)
+{
+	if(x1 > x2 || y1 > y2 || x2 >= DISPLAY_WIDTH || y2 >= DISPLAY_HEIGHT)
+	{
+		x1 = 0;
+		y1 = 0;
+		x2 = DISPLAY_WIDTH -1;
+		y2 = DISPLAY_HEIGHT -1;
+	}
+	this->Bounds.x1 = x1;
+	this->Bounds.y1 = y1;
+	this->Bounds.x2 = x2;
+	this->Bounds.y2 = y2;
+}
+
+/**
+ * Set the background of the sprite area and redraw it
+ *
+ * @param bitmap glcd bitmap in program memory, or 0 for no bitmap
+ * @param color WHITE or BLACK
+ *
+ * The background is the area filled with color, with the bitmap drawn
+ * over it at the upper left corner of the area like DrawBitmap()
+ * draws it, so with a BLACK background the bitmap is inverted.
+ *
+ * Color is optional and defaults to WHITE.
+ *
+ * The bitmap can be compressed.
+ *
+ * @see Redraw()
+ */
+void gSpriteArea::SetBackground(Image_t bitmap, uint8_t color)
+{
+	this->Background = bitmap;
+	this->BgColor = color;
+	this->Redraw();
+}
+
+/*
+ * Put a sprite in the list after the ones with
+ * the same or lower z so it is drawn over them
+ */
+void gSpriteArea::Link(gSprite *sprite)
+{
+gSprite **link;
+
+	for(link = &this->Sprites; *link && (*link)->Z <= sprite->Z; link = &(*link)->Next)
+		;
+	sprite->Next = *link;
+	*link = sprite;
+}
+
+void gSpriteArea::Unlink(gSprite *sprite)
+{
+gSprite **link;
+
+	for(link = &this->Sprites; *link; link = &(*link)->Next)
+	{
+		if(*link == sprite)
+		{
+			*link = sprite->Next;
+			break;
+		}
+	}
+	sprite->Next = 0;
+}
+
+/**
+ * Add a sprite to the sprite area
+ *
+ * @param sprite the sprite
+ *
+ * A sprite is in one area at a time, adding it takes it out of any other area.
+ * If it is shown, the sprite is drawn by the next Update().
+ *
+ * @see Remove()
+ */
+void gSpriteArea::Add(gSprite &sprite)
+{
+	if(sprite.Area == this)
+		return;
+	if(sprite.Area)
+		sprite.Area->Remove(sprite);
+	sprite.Area = this;
+	this->Link(&sprite);
+	sprite.Flags |= GSPRITE_DIRTY;
+}
+
+/**
+ * Take a sprite out of the sprite area
+ *
+ * @param sprite the sprite
+ *
+ * The sprite is erased right away.
+ *
+ * @see Add()
+ */
+void gSpriteArea::Remove(gSprite &sprite)
+{
+	if(sprite.Area != this)
+		return;
+	this->Unlink(&sprite);
+	sprite.Area = 0;
+	if(sprite.Flags & GSPRITE_DRAWN)
+	{
+		sprite.Flags &= ~GSPRITE_DRAWN;
+		this->Compose(&sprite.Drawn);
+	}
+}
+
+/*
+ * Get the part of the sprite area a sprite covers.
+ * Returns 0 if the sprite is not drawn.
+ */
+uint8_t gSpriteArea::SpriteRect(gSprite *sprite, spriteRect_t *rect)
+{
+int16_t x1, y1, x2, y2;
+
+	if(!(sprite->Flags & GSPRITE_SHOWN) || !sprite->Image)
+		return(0);
+
+	x1 = sprite->X;
+	if(x1 >= DISPLAY_WIDTH)
+		x1 -= 256;
+	y1 = sprite->Y;
+	if(y1 >= DISPLAY_HEIGHT)
+		y1 -= 256;
+	x2 = x1 + bitmapWidth(sprite->Image) - 1;
+	y2 = y1 + bitmapHeight(sprite->Image) - 1;
+
+	if(x1 < this->Bounds.x1)
+		x1 = this->Bounds.x1;
+	if(x2 > this->Bounds.x2)
+		x2 = this->Bounds.x2;
+	if(y1 < this->Bounds.y1)
+		y1 = this->Bounds.y1;
+	if(y2 > this->Bounds.y2)
+		y2 = this->Bounds.y2;
+	if(x1 > x2 || y1 > y2)
+		return(0);
+
+	rect->x1 = x1;
+	rect->x2 = x2;
+	rect->p1 = y1/8;
+	rect->p2 = y2/8;
+	return(1);
+}
+
+/*
+ * Redraw the columns and pages of rect that are inside the sprite area.
+ *
+ * The area is redrawn a page at a time, GLCD_BLKSIZE columns at a time.
+ * Each byte is put together in a buffer, starting from the background
+ * and adding the sprites over it in z order, then written just once.
+ * Since whole pages are put together, the display is only read on
+ * pages the sprite area or the clip area partly covers.
+ *
+ * Pages and columns only go ahead, so compressed bitmaps are decoded as they
+ * are drawn, with a pair of decoders for the background and for each sprite
+ * image and mask, and each of them is decoded at most once per call.
+ */
+void gSpriteArea::Compose(spriteRect_t *rect)
+{
+uint8_t buf[GLCD_BLKSIZE];
+uint8_t orig[GLCD_BLKSIZE];
+int16_t col, left, right, top, bottom, row, sx, sy, c;
+uint8_t page, n, i, keep, width, height, data, mask;
+gSprite *sprite;
+unpackState_t bg[2];
+unpackState_t *bgunpack, *unpack, *maskunpack;
+
+	/*
+	 * rect can be where a sprite was drawn before the area was changed
+	 * by DefineArea(), so it is cut down to the sprite area and the clip area
+	 */
+	left = rect->x1;
+	if(left < this->Bounds.x1)
+		left = this->Bounds.x1;
+	if(left < this->Clip.x1)
+		left = this->Clip.x1;
+	right = rect->x2;
+	if(right > this->Bounds.x2)
+		right = this->Bounds.x2;
+	if(right > this->Clip.x2)
+		right = this->Clip.x2;
+	top = this->Bounds.y1;
+	if(top < this->Clip.y1)
+		top = this->Clip.y1;
+	bottom = this->Bounds.y2;
+	if(bottom > this->Clip.y2)
+		bottom = this->Clip.y2;
+	if(left > right || top > bottom)
+		return;
+
+	bgunpack = gSprite_Unpack(this->Background, bg);
+	for(sprite = this->Sprites; sprite; sprite = sprite->Next)
+	{
+		gSprite_Unpack(sprite->Image, &sprite->Unpack[0]);
+		gSprite_Unpack(sprite->Mask, &sprite->Unpack[2]);
+	}
+
+	for(page = rect->p1; page <= rect->p2; page++)
+	{
+		row = page*8;
+		if(top > row+7 || bottom < row)
+			continue;
+		keep = 0xff;
+		if(top > row)
+			keep <<= top - row;
+		if(bottom < row+7)
+			keep &= 0xff >> (row+7 - bottom);
+
+		for(col = left; col <= right; col += n)
+		{
+			n = GLCD_BLKSIZE;
+			if(n > right - col + 1)
+				n = right - col + 1;
+
+			this->GotoXY(col, row);
+			if(keep != 0xff)
+				this->ReadDataBlock(orig, n);
+
+			/*
+			 * Background
+			 */
+			width = 0;
+			height = 0;
+			if(this->Background)
+			{
+				width = bitmapWidth(this->Background);
+				height = bitmapHeight(this->Background);
+			}
+			for(i = 0; i < n; i++)
+			{
+				c = col + i - this->Bounds.x1;
+				if(c < width)
+					buf[i] = gSprite_BitmapByte(this->Background, bgunpack, width, height, c, row - this->Bounds.y1);
+				else
+					buf[i] = 0;
+				buf[i] ^= this->BgColor;
+			}
+
+			/*
+			 * Sprites, lowest z first
+			 */
+			for(sprite = this->Sprites; sprite; sprite = sprite->Next)
+			{
+				if(!(sprite->Flags & GSPRITE_SHOWN) || !sprite->Image)
+					continue;
+				width = bitmapWidth(sprite->Image);
+				height = bitmapHeight(sprite->Image);
+				sx = sprite->X;
+				if(sx >= DISPLAY_WIDTH)
+					sx -= 256;
+				sy = sprite->Y;
+				if(sy >= DISPLAY_HEIGHT)
+					sy -= 256;
+				if(sy > row+7 || sy + height <= row || sx > col + n - 1 || sx + width <= col)
+					continue;
+				unpack = ReadPgmData(sprite->Image) ? 0 : &sprite->Unpack[0];
+				maskunpack = (!sprite->Mask || ReadPgmData(sprite->Mask)) ? 0 : &sprite->Unpack[2];
+
+				for(i = 0; i < n; i++)
+				{
+					c = col + i - sx;
+					if(c < 0 || c >= width)
+						continue;
+					data = gSprite_BitmapByte(sprite->Image, unpack, width, height, c, row - sy);
+					if(sprite->Mask)
+						mask = gSprite_BitmapByte(sprite->Mask, maskunpack, width, height, c, row - sy);
+					else
+						mask = data;
+					buf[i] = (buf[i] & ~mask) | (data & mask);
+				}
+			}
+
+			if(keep != 0xff)
+			{
+				for(i = 0; i < n; i++)
+					buf[i] = (orig[i] & ~keep) | (buf[i] & keep);
+			}
+			this->WriteDataBlock(buf, n);
+		}
+	}
+}
+
+/**
+ * Bring the sprite area up to date
+ *
+ * Redraws the parts of the area that the sprites changed since the last Update()
+ * were in and are now in. Areas that overlap are merged and redrawn together.
+ * Everything else in the sprite area is left alone, so the area must not be
+ * drawn on other than through its sprites, or must be redrawn with Redraw().
+ *
+ * For smooth animation change all the sprites and then call Update() once per frame.
+ *
+ * @see Redraw()
+ */
+void gSpriteArea::Update(void)
+{
+spriteRect_t rects[GLCD_SPRITE_RECTS];
+uint8_t count = 0;
+gSprite *sprite;
+
+	for(sprite = this->Sprites; sprite; sprite = sprite->Next)
+	{
+		if(!(sprite->Flags & GSPRITE_DIRTY))
+			continue;
+		if(sprite->Flags & GSPRITE_DRAWN)
+			count = gSprite_AddRect(rects, count, &sprite->Drawn);
+		sprite->Flags &= ~(GSPRITE_DIRTY | GSPRITE_DRAWN);
+		if(this->SpriteRect(sprite, &sprite->Drawn))
+		{
+			count = gSprite_AddRect(rects, count, &sprite->Drawn);
+			sprite->Flags |= GSPRITE_DRAWN;
+		}
+	}
+	while(count)
+		this->Compose(&rects[--count]);
+}
+
+/**
+ * Redraw the entire sprite area
+ *
+ * Draws the background and all the shown sprites of the area,
+ * for example after the display has been cleared.
+ *
+ * @see Update()
+ */
+void gSpriteArea::Redraw(void)
+{
+spriteRect_t rect;
+gSprite *sprite;
+
+	for(sprite = this->Sprites; sprite; sprite = sprite->Next)
+	{
+		sprite->Flags &= ~(GSPRITE_DIRTY | GSPRITE_DRAWN);
+		if(this->SpriteRect(sprite, &sprite->Drawn))
+			sprite->Flags |= GSPRITE_DRAWN;
+	}
+	rect.x1 = this->Bounds.x1;
+	rect.x2 = this->Bounds.x2;
+	rect.p1 = this->Bounds.y1/8;
+	rect.p2 = this->Bounds.y2/8;
+	this->Compose(&rect);
+}
@@ -38,6 +38,14 @@ extern "C"
 
 //#define GLCD_OLD_FONTDRAW    // uncomment this define to get old font rendering (not recommended)
 
+/*
+ * While Step() is outputting a character, text scrolls are handed to it
+ * through gText_stepscroll so it can do them a page at a time.
+ * gText_nowrap is set when Step() has already wrapped the character.
+ */
+static scrollState_t *gText_stepscroll;
+static uint8_t gText_nowrap;
+
 	
 //extern glcd_Device GLCD; // this is the global GLCD instance, here upcast to the base glcd_Device class 
 
@@ -259,6 +267,22 @@ TareaToken tok;
 	return this->DefineArea(x1,y1,x2,y2, mode);
 }
 
+/*
+ * Returns the bits of a page that are rows lo through hi inclusive.
+ */
+static uint8_t PageRowMask(uint8_t page, int16_t lo, int16_t hi)
+{
+int16_t top = page * 8;
+
+	if(lo < top)
+		lo = top;
+	if(hi > top + 7)
+		hi = top + 7;
+	if(lo > hi)
+		return(0);
+	return((0xff << (lo - top)) & (0xff >> (top + 7 - hi)));
+}
+
 /*
  * Scroll a pixel region up.
  * 	Area scrolled is defined by x1,y1 through x2,y2 inclusive.
@@ -269,19 +293,77 @@ TareaToken tok;
  *
  *	pixels is the *exact* pixels to scroll. 1 is 1 and 9 is 9 it is
  *  not 1 less or 1 more than what you want. It is *exact*.
+ *
+ *  When called from Step() the scroll is only started here
+ *  and Step() does it a page at a time.
+ *
+ *  When the region is the whole display and pixels is a multiple of 8,
+ *  the scroll is done by moving the display start line on devices
+ *  that support it, which only has to clear the new rows.
  */
 
 void gText::ScrollUp(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, 
 	uint8_t pixels, uint8_t color)
 {
-uint8_t dy;
-uint8_t dbyte;
-uint8_t sy;
-uint8_t sbyte;
-uint8_t col;
+scrollState_t scroll;
+
+	if(gText_stepscroll)
+	{
+		while(this->ScrollPage(gText_stepscroll))	// finish any earlier scroll
+			;
+		this->ScrollStart(gText_stepscroll, x1, y1, x2, y2, pixels, color, SCROLL_UP);
+		return;
+	}
+	this->ScrollStart(&scroll, x1, y1, x2, y2, pixels, color, SCROLL_UP);
+	while(this->ScrollPage(&scroll))
+		;
+}
+
+#ifndef GLCD_NO_SCROLLDOWN
+
+/*
+ * Scroll a pixel region down.
+ *
+ *  Same as ScrollUp() except the created space is along the top.
+ */
+
+void gText::ScrollDown(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, 
+	uint8_t pixels, uint8_t color)
+{
+scrollState_t scroll;
+
+	if(gText_stepscroll)
+	{
+		while(this->ScrollPage(gText_stepscroll))	// finish any earlier scroll
+			;
+		this->ScrollStart(gText_stepscroll, x1, y1, x2, y2, pixels, color, SCROLL_DOWN);
+		return;
+	}
+	this->ScrollStart(&scroll, x1, y1, x2, y2, pixels, color, SCROLL_DOWN);
+	while(this->ScrollPage(&scroll))
+		;
+}
+#endif //GLCD_NO_SCROLLDOWN
+
+/*
+ * Set up a scroll for ScrollPage()
+ */
+
+void gText::ScrollStart(scrollState_t *scroll, uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2,
+	uint8_t pixels, uint8_t color, textMode dir)
+{
+	scroll->x2 = x2;
+	scroll->y1 = y1;
+	scroll->y2 = y2;
+	scroll->pixels = pixels;
+	scroll->color = color;
+	scroll->dir = dir;
+	scroll->col = x1;
+	scroll->n = 0;
+	scroll->cur = 0;
 
 	/*
-	 * Scrolling up more than area height?
+	 * Scrolling more than area height?
 	 */
 	if(y1 + pixels > y2)
 	{
@@ -290,218 +372,170 @@ uint8_t col;
 		 * it is being totally scrolled out.
 		 */
 		glcd_Device::SetPixels(x1, y1, x2, y2, color);
-		return;
+		scroll->col = x2 + 1;	// nothing left to do
 	}
-
-	for(col = x1; col <= x2; col++)
+#ifdef GLCD_HWSCROLL
+	else if(x1 == 0 && y1 == 0 && x2 == DISPLAY_WIDTH-1 && y2 == DISPLAY_HEIGHT-1
+		&& pixels && !(pixels & 7))
 	{
-		dy = y1;
-		glcd_Device::GotoXY(col, dy & ~7);
-		dbyte = glcd_Device::ReadData();
-
-
 		/*
-		 * preserve bits outside/above scroll region
+		 * The whole display scrolls by whole memory pages so just move
+		 * the display start line and clear the rows that scroll in.
 		 */
-
-		dbyte &= (_BV((dy & 7)) - 1);
-
-		sy = dy + pixels;
-		glcd_Device::GotoXY(col, sy & ~7);
-		sbyte = glcd_Device::ReadData();
-
-		while(sy <= y2)
-		{
-			if(sbyte & _BV(sy & 7))
-			{
-				dbyte |= _BV(dy & 7);
-			}
-
-			sy++;
-			if((sy & 7) == 0)
-			{
-				/*
-				 * If we just crossed over, then we should be done.
-				 */
-				if(sy < DISPLAY_HEIGHT)
-				{
-					glcd_Device::GotoXY(col, sy & ~7);
-					sbyte = glcd_Device::ReadData();
-				}
-			}
-
-			if((dy & 7) == 7)
-			{
-				glcd_Device::GotoXY(col, dy & ~7);	// Should be able to remove this
-				glcd_Device::WriteData(dbyte);
-				dbyte = 0;
-			}
-			dy++;
-		}
-
-		/*
-		 * Handle the new area at the bottom of the region
-		 */
-
-		for(uint8_t p = pixels; p; p--)
+#ifndef GLCD_NO_SCROLLDOWN
+		if(dir == SCROLL_DOWN)
 		{
-			if(color == BLACK)
-			{
-				dbyte |= _BV(dy & 7);
-			}
-			else
-			{
-				dbyte &= ~_BV(dy & 7);
-			}
-
-			if((dy & 7) == 7)
-			{
-				glcd_Device::GotoXY(col, dy & ~7); // should be able to remove this.
-				glcd_Device::WriteData(dbyte);
-				dbyte = 0;
-			}
-			dy++;
+			glcd_Device::ScrollPages(-(pixels/8));
+			glcd_Device::SetPixels(x1, y1, x2, y1 + pixels - 1, color);
 		}
-
-		/*
-		 * Flush out the final destination byte
-		 */
-
-
-		if(dy & 7)
+		else
+#endif
 		{
-			dy--;
-
-			glcd_Device::GotoXY(col, dy & ~7);
-			sbyte = glcd_Device::ReadData();
-			/*
-			 * Preserver bits outside/below region
-			 */
-
-			dy++;
-			sbyte &= ~(_BV((dy & 7)) - 1);
-			dbyte |= sbyte;
-
-			glcd_Device::WriteData(dbyte);
+			glcd_Device::ScrollPages(pixels/8);
+			glcd_Device::SetPixels(x1, y2 - pixels + 1, x2, y2, color);
 		}
+		scroll->col = x2 + 1;	// nothing left to do
 	}
-
+#endif
 }
 
-#ifndef GLCD_NO_SCROLLDOWN
+/*
+ * Scroll one destination page of a block of columns.
+ *
+ *  The region is processed a block of columns at a time using block
+ *  reads and writes. For a scroll up the pages of a block are done from
+ *  the top down, for a scroll down from the bottom up.
+ *  Each destination page is built from the two source pages that hold
+ *  its source rows. The second of the two is carried over to the next
+ *  destination page, so each source page is only read once.
+ *
+ *  Returns non zero until the scroll is complete.
+ */
 
-void gText::ScrollDown(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, 
-	uint8_t pixels, uint8_t color)
+uint8_t gText::ScrollPage(scrollState_t *scroll)
 {
-uint8_t dy;
-uint8_t dbyte;
-uint8_t sy;
-uint8_t sbyte;
-uint8_t col;
+uint8_t dbuf[GLCD_BLKSIZE];
+uint8_t *sbuf0, *sbuf1;
+uint8_t n, i, shift, lastpage;
+uint8_t regmask, fillmask, copymask;
 
-	/*
-	 * Scrolling up more than area height?
-	 */
-	if(y1 + pixels > y2)
+	if(scroll->col > scroll->x2)
+		return(0);
+
+	if(!scroll->n)
 	{
 		/*
-		 * fill the region with "whitespace" because
-		 * it is being totally scrolled out.
+		 * Start the next block of columns by reading the
+		 * source page of its first destination page.
 		 */
-		glcd_Device::SetPixels(x1, y1, x2, y2, color);
-		return;
+		n = scroll->x2 - scroll->col + 1;
+		if(n > GLCD_BLKSIZE)
+			n = GLCD_BLKSIZE;
+		scroll->n = n;
+
+#ifndef GLCD_NO_SCROLLDOWN
+		if(scroll->dir == SCROLL_DOWN)
+		{
+			scroll->page = scroll->y2/8;
+			scroll->spage = (scroll->page * 8 - scroll->pixels + 7) / 8;
+		}
+		else
+#endif
+		{
+			scroll->page = scroll->y1/8;
+			scroll->spage = scroll->y1/8 + scroll->pixels/8;
+		}
+		glcd_Device::GotoXY(scroll->col, scroll->spage * 8);
+		glcd_Device::ReadDataBlock(scroll->buf[scroll->cur], n);
 	}
+	n = scroll->n;
 
-	/*
-	 * Process region from left to right
-	 */
-	for(col = x1; col <= x2; col++)
+#ifndef GLCD_NO_SCROLLDOWN
+	if(scroll->dir == SCROLL_DOWN)
 	{
-		dy = y2;
-		glcd_Device::GotoXY(col, dy & ~7);
-		dbyte = glcd_Device::ReadData();
-
 		/*
-		 * preserve bits outside/below scroll region
+		 * Destination rows of this page come from source pages
+		 * spage-1 and spage. Source rows above y1 are never used.
+		 * The source rows start pixels rows above the page,
+		 * which is shift rows down into source page spage-1.
 		 */
-
-		dbyte &= ~(_BV(((dy & 7)+1)) - 1);
-		sy = dy - pixels;
-		glcd_Device::GotoXY(col, sy & ~7);
-		sbyte = glcd_Device::ReadData();
-
-		while(sy >= y1)
+		sbuf1 = scroll->buf[scroll->cur];
+		sbuf0 = scroll->buf[scroll->cur ^ 1];
+		scroll->spage--;
+		if(scroll->spage >= (int8_t)(scroll->y1/8))
 		{
-			if(sbyte & _BV(sy & 7))
-			{
-				dbyte |= _BV(dy & 7);
-			}
-			if((dy & 7) == 0)
-			{
-				glcd_Device::GotoXY(col, dy & ~7);	// Should be able to remove this
-				glcd_Device::WriteData(dbyte);
-				dbyte = 0;
-			}
-			dy--;
-
-			if(!sy)
-				break; /* if we bottomed out, we are done */
-			sy--;
-			if((sy & 7) == 7)
-			{
-				glcd_Device::GotoXY(col, sy & ~7);
-				sbyte = glcd_Device::ReadData();
-			}
-
+			glcd_Device::GotoXY(scroll->col, scroll->spage * 8);
+			glcd_Device::ReadDataBlock(sbuf0, n);
 		}
-
+		shift = (8 - (scroll->pixels & 7)) & 7;
+		if(!shift)
+			sbuf0 = sbuf1;
+		fillmask = PageRowMask(scroll->page, scroll->y1, scroll->y1 + scroll->pixels - 1);
+		lastpage = scroll->y1/8;
+	}
+	else
+#endif
+	{
 		/*
-		 * Handle the new area at the top of the column
+		 * Destination rows of this page come from source pages
+		 * spage and spage+1. Source rows beyond y2 are never used.
 		 */
-
-		for(uint8_t p = pixels; p; p--)
+		sbuf0 = scroll->buf[scroll->cur];
+		sbuf1 = scroll->buf[scroll->cur ^ 1];
+		if(scroll->spage < scroll->y2/8)
 		{
-			if(color == BLACK)
-			{
-				dbyte |= _BV(dy & 7);
-			}
-			else
-			{
-				dbyte &= ~_BV(dy & 7);
-			}
-
-			if((dy & 7) == 0)
-			{
-				glcd_Device::GotoXY(col, dy & ~7); // should be able to remove this.
-				glcd_Device::WriteData(dbyte);
-				dbyte = 0;
-			}
-			dy--;
+			glcd_Device::GotoXY(scroll->col, (scroll->spage+1) * 8);
+			glcd_Device::ReadDataBlock(sbuf1, n);
 		}
+		scroll->spage++;
+		shift = scroll->pixels & 7;
+		fillmask = PageRowMask(scroll->page, scroll->y2 - scroll->pixels + 1, scroll->y2);
+		lastpage = scroll->y2/8;
+	}
+	scroll->cur ^= 1;
 
-		dy++; /* point dy back to last destination row */
+	regmask = PageRowMask(scroll->page, scroll->y1, scroll->y2);
+	copymask = regmask & ~fillmask;
 
+	glcd_Device::GotoXY(scroll->col, scroll->page * 8);
+	if(regmask != 0xff)
+	{
 		/*
-		 * Flush out the final destination byte
+		 * preserve bits outside the scroll region
 		 */
+		glcd_Device::ReadDataBlock(dbuf, n);
+	}
 
-		if(dy & 7)
-		{
-			glcd_Device::GotoXY(col, dy & ~7);
-			sbyte = glcd_Device::ReadData();
-			/*
-			 * Preserve bits outside/above region
-			 */
+	for(i = 0; i < n; i++)
+	{
+	uint8_t sbyte;
 
-			sbyte &= (_BV((dy & 7)) - 1);
-			dbyte |= sbyte;
-			glcd_Device::WriteData(dbyte);
-		}
+		if(shift)
+			sbyte = (sbuf0[i] >> shift) | (sbuf1[i] << (8 - shift));
+		else
+			sbyte = sbuf0[i];
+		dbuf[i] = (dbuf[i] & ~regmask) | (sbyte & copymask) | (scroll->color & fillmask);
+	}
+	glcd_Device::WriteDataBlock(dbuf, n);
 
+	/*
+	 * move on to the next page or the next block of columns
+	 */
+	if(scroll->page == lastpage)
+	{
+		scroll->col += n;
+		scroll->n = 0;
 	}
+#ifndef GLCD_NO_SCROLLDOWN
+	else if(scroll->dir == SCROLL_DOWN)
+		scroll->page--;
+#endif
+	else
+		scroll->page++;
 
+	return(scroll->col <= scroll->x2);
 }
-#endif //GLCD_NO_SCROLLDOWN
+
 
 
 /*
@@ -659,6 +693,50 @@ void gText::SpecialChar(uint8_t c)
 
 }
 
+/*
+ * Wrap the text position to the next line when a character
+ * of the given width won't fit on the current line.
+ */
+void gText::WrapChar(uint8_t width)
+{
+#ifndef GLCD_NODEFER_SCROLL
+	/*
+	 * check for a defered scroll
+	 * If there is a deferred scroll,
+	 * Fake a newline to complete it.
+	 */
+
+	if(this->need_scroll)
+	{
+		this->PutChar('\n'); // fake a newline to cause wrap/scroll
+		this->need_scroll = 0;
+	}
+#endif
+
+	/*
+	 * If the character won't fit in the text area,
+	 * fake a newline to get the text area to wrap and 
+	 * scroll if necessary.
+	 * NOTE/WARNING: the below calculation assumes a 1 pixel pad.
+	 * This will need to be changed if/when configurable pixel padding is supported.
+	 */
+	if(this->x + width > this->tarea.x2)
+	{
+		this->PutChar('\n'); // fake a newline to cause wrap/scroll
+#ifndef GLCD_NODEFER_SCROLL
+		/*
+		 * We can't defer a scroll at this point since we need to ouput
+		 * a character right now.
+		 */
+		if(this->need_scroll)
+		{
+			this->PutChar('\n'); // fake a newline to cause wrap/scroll
+			this->need_scroll = 0;
+		}
+#endif
+	}
+}
+
 /**
  * output a character
  *
@@ -748,42 +826,8 @@ int gText::PutChar(uint8_t c)
 	   width = FontRead(this->Font+FONT_WIDTH_TABLE+c);
     }
 
-#ifndef GLCD_NODEFER_SCROLL
-	/*
-	 * check for a defered scroll
-	 * If there is a deferred scroll,
-	 * Fake a newline to complete it.
-	 */
-
-	if(this->need_scroll)
-	{
-		this->PutChar('\n'); // fake a newline to cause wrap/scroll
-		this->need_scroll = 0;
-	}
-#endif
-
-	/*
-	 * If the character won't fit in the text area,
-	 * fake a newline to get the text area to wrap and 
-	 * scroll if necessary.
-	 * NOTE/WARNING: the below calculation assumes a 1 pixel pad.
-	 * This will need to be changed if/when configurable pixel padding is supported.
-	 */
-	if(this->x + width > this->tarea.x2)
-	{
-		this->PutChar('\n'); // fake a newline to cause wrap/scroll
-#ifndef GLCD_NODEFER_SCROLL
-		/*
-		 * We can't defer a scroll at this point since we need to ouput
-		 * a character right now.
-		 */
-		if(this->need_scroll)
-		{
-			this->PutChar('\n'); // fake a newline to cause wrap/scroll
-			this->need_scroll = 0;
-		}
-#endif
-	}
+	if(!gText_nowrap)
+		this->WrapChar(width);
 
 	// last but not least, draw the character
 
@@ -870,20 +914,79 @@ int gText::PutChar(uint8_t c)
 	uint8_t dp;
 	uint8_t dbyte;
 	uint8_t fdata;
+	uint8_t orig;
+	uint8_t keep;	/* pixels of the LCD page inside the clip area */
+	uint8_t rmask;	/* pixels of the LCD page combined using the raster op */
+	uint8_t rop = this->FontRop;
+	uint8_t row;
 
-	for(p = 0; p < pixels;)
+	/*
+	 * Only paint the columns of the character that are inside the clip area,
+	 * jlo to jhi where column width is the gap after the character.
+	 */
+	int16_t jlo, jhi, jend;
+
+	jlo = (int16_t)this->Clip.x1 - this->x;
+	if(jlo < 0)
+		jlo = 0;
+	jhi = (int16_t)this->Clip.x2 - this->x;
+	if(jhi > width)
+		jhi = width;
+	jend = jhi < width ? jhi+1 : width;
+
+	for(p = 0; p < pixels && jlo <= jhi;)
 	{
 		dy = this->y + p;
 
+		/*
+		 * Skip LCD pages outside the clip area and note the pixels
+		 * of the ones partly inside it.
+		 */
+		row = dy & ~7;
+		keep = 0;
+		if(this->Clip.y1 <= row+7 && this->Clip.y2 >= row)
+		{
+			keep = 0xff;
+			if(this->Clip.y1 > row)
+				keep <<= this->Clip.y1 - row;
+			if(this->Clip.y2 < row+7)
+				keep &= 0xff >> (row+7 - this->Clip.y2);
+		}
+		if(!keep)
+		{
+			p += 8 - (dy & 7);
+			continue;
+		}
+
+		/*
+		 * With a raster op other than copy, the pixels painted
+		 * are combined with those already on the display.
+		 */
+		rmask = keep & (0xff << (dy & 7));
+		if(pixels - p < 8 - (dy & 7))
+			rmask &= 0xff >> (8 - (dy & 7) - (pixels - p));
+
 		/*
 		 * Align to proper Column and page in LCD memory
 		 */
 
-		glcd_Device::GotoXY(this->x, (dy & ~7));
+		glcd_Device::GotoXY(this->x+jlo, row);
 
 		uint16_t page = p/8 * width; // page must be 16 bit to prevent overflow
 
-		for(uint8_t j=0; j<width; j++) /* each column of font data */
+		if(!(dy & 7) && !(p & 7) && (height - p) >= 8 && keep == 0xff && rop == GLCD_ROP_COPY
+			&& FontRead == ReadPgmData)
+		{
+			/*
+			 * A full page of font data going to a page boundary
+			 * is the font data as is, so burst the whole row
+			 * straight out of flash.
+			 */
+			if(jlo < jend)
+				glcd_Device::WriteDataBlock_P(this->Font+index+page+jlo, jend-jlo, this->FontColor);
+		}
+		else
+		for(uint8_t j=jlo; j<jend; j++) /* each column of font data */
 		{
 			
 			/*
@@ -935,7 +1038,7 @@ int gText::PutChar(uint8_t c)
 			 * data can be done.
 			 */
 
-			if(!(dy & 7) && !(p & 7) && ((pixels -p) >= 8))
+			if(!(dy & 7) && !(p & 7) && ((pixels -p) >= 8) && keep == 0xff && rop == GLCD_ROP_COPY)
 			{
 				/*
 				 * destination pixel is on a page boundary
@@ -953,6 +1056,7 @@ int gText::PutChar(uint8_t c)
 					 * No, so must fetch byte from LCD memory.
 					 */
 					dbyte = glcd_Device::ReadData();
+					orig = dbyte;
 			}
 
 			/*
@@ -1007,8 +1111,13 @@ int gText::PutChar(uint8_t c)
 			}
 
 			/*
-			 * Now flush out the painted byte.
+			 * Now flush out the painted byte,
+			 * less any pixels outside the clip area.
 			 */
+			if(rop != GLCD_ROP_COPY)
+				dbyte = (orig & ~rmask) | (RopData(rop, dbyte, orig) & rmask);
+			else if(keep != 0xff)
+				dbyte = (orig & ~keep) | (dbyte & keep);
 			glcd_Device::WriteData(dbyte);
 		}
 
@@ -1033,34 +1142,39 @@ int gText::PutChar(uint8_t c)
 
 
 		
-		if((dy & 7) || (pixels - p < 8))
+		if(jhi == width)	/* the gap is inside the clip area */
 		{
-		uint8_t mask = 0;
+			if((dy & 7) || (pixels - p < 8) || keep != 0xff || rop != GLCD_ROP_COPY)
+			{
+			uint8_t mask = ~keep;
 
-			dbyte = glcd_Device::ReadData();
+				dbyte = glcd_Device::ReadData();
 
-			if(dy & 7)
-				mask |= _BV(dy & 7) -1;
+				if(dy & 7)
+					mask |= _BV(dy & 7) -1;
 
-			if((pixels-p) < 8)
-				mask |= ~(_BV(pixels - p) -1);
+				if((pixels-p) < 8)
+					mask |= ~(_BV(pixels - p) -1);
 
 
-			if(this->FontColor == WHITE)
-				dbyte |= ~mask;	
-			else
-				dbyte &= mask;
+				if(rop != GLCD_ROP_COPY)
+					dbyte = (dbyte & mask) | (RopData(rop, this->FontColor == WHITE ? 0xff : 0, dbyte) & ~mask);
+				else if(this->FontColor == WHITE)
+					dbyte |= ~mask;	
+				else
+					dbyte &= mask;
 
-		}
-		else
-		{
-			if(this->FontColor == WHITE)
-				dbyte = 0xff;
+			}
 			else
-				dbyte = 0;
-		}
+			{
+				if(this->FontColor == WHITE)
+					dbyte = 0xff;
+				else
+					dbyte = 0;
+			}
 
-		glcd_Device::WriteData(dbyte);
+			glcd_Device::WriteData(dbyte);
+		}
 
 		/*
 		 * advance the font pixel for the pixels
@@ -1134,7 +1248,7 @@ void gText::Puts(char *str)
  */
 void gText::Puts(const String &str)
 {
-	for (int i = 0; i < str.length(); i++)
+	for (unsigned int i = 0; i < str.length(); i++)
 	{
 		write(str[i]);
 	}
@@ -1253,6 +1367,238 @@ void gText::DrawString_P(PGM_P str, uint8_t x, uint8_t y)
 	this->Puts_P(str);
 }
 
+/*
+ * The operation Step() is working on
+ */
+static struct
+{
+	uint8_t op;				// GLCD_STEP_xxx, 0 when there is nothing to do
+	uint8_t x1, y1, x2, y2;	// area of a fill or bitmap
+	uint8_t color;
+	uint8_t col, y;			// next block of a fill or bitmap
+	uint8_t bx, by;			// upper left corner of a bitmap
+	uint8_t wrapped;		// current string character has been wrapped
+	const uint8_t *data;	// bitmap data or string
+	gText *text;			// text area of a string
+	scrollState_t scroll;	// text scroll in progress
+} gText_step;
+
+/*
+ * Start an operation for Step(), after finishing any previous one.
+ * Used by the glcd class for its operations.
+ */
+void gText::StepStart(uint8_t op, uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2,
+	uint8_t color, const void *data, uint8_t bx, uint8_t by)
+{
+	while(this->Step(-1))
+		;
+
+	if(x2 >= DISPLAY_WIDTH)
+		x2 = DISPLAY_WIDTH-1;
+	if(y2 >= DISPLAY_HEIGHT)
+		y2 = DISPLAY_HEIGHT-1;
+	if(x1 > x2 || y1 > y2)
+		return;
+
+	gText_step.x1 = x1;
+	gText_step.y1 = y1;
+	gText_step.x2 = x2;
+	gText_step.y2 = y2;
+	gText_step.color = color;
+	gText_step.col = x1;
+	gText_step.y = y1;
+	gText_step.bx = bx;
+	gText_step.by = by;
+	gText_step.wrapped = 0;
+	gText_step.data = (const uint8_t *) data;
+	gText_step.text = this;
+	gText_step.scroll.col = 1;	// no scroll in progress
+	gText_step.scroll.x2 = 0;
+	gText_step.op = op;
+}
+
+/*
+ * Wrap a string character for Step()
+ * The wrap can start a scroll which has to finish before the
+ * character is drawn.
+ */
+void gText::StepWrap(uint8_t c)
+{
+uint8_t firstChar = FontRead(this->Font+FONT_FIRST_CHAR);
+uint8_t charCount = FontRead(this->Font+FONT_CHAR_COUNT);
+
+	if(this->Font == 0 || c < firstChar || c >= (firstChar+charCount))
+		return; // PutChar() won't draw it
+
+	this->WrapChar(this->CharWidth(c) - 1);	// CharWidth() includes the pad pixel
+}
+
+/**
+ * Do part of a drawing operation
+ *
+ * @param us the time in microseconds to spend
+ *
+ * Continues the operation started by one of the Step functions like
+ * StepDrawString(), StepFillRect(), StepClearScreen() and StepDrawBitmap().
+ * Step() returns once the time is used up so that long drawing
+ * operations can be spread across calls from a cooperative scheduler or loop().
+ *
+ * The operation is broken up into small pieces, each at most
+ * GLCD_BLKSIZE columns of one memory page or a single character.
+ * Step() always does at least one piece and returns after
+ * the piece during which the time ran out, so it can take a bit longer
+ * than the time given.
+ *
+ * Text scrolls that are caused by a string are also done a piece at a time.
+ *
+ * Only one operation can be in progress. Starting a new one
+ * finishes the previous one first.
+ *
+ * @returns non zero while the operation is not yet complete
+ *
+ * Example:
+ * @code
+ * GLCD.StepDrawBitmap(icon, 0, 0);
+ * ...
+ * void loop()
+ * {
+ *	ReadSensor();
+ *	GLCD.Step(200);	// spend up to about 200us on the display
+ * }
+ * @endcode
+ *
+ * @see StepDrawString()
+ * @see StepClearScreen()
+ * @see StepFillRect()
+ * @see StepDrawBitmap()
+ */
+
+uint8_t gText::Step(uint16_t us)
+{
+unsigned long start = micros();
+uint8_t n, c, y2;
+
+	while(gText_step.op)
+	{
+		if(gText_step.scroll.col <= gText_step.scroll.x2)
+		{
+			this->ScrollPage(&gText_step.scroll);
+		}
+		else if(gText_step.op == GLCD_STEP_FILL || gText_step.op == GLCD_STEP_BITMAP)
+		{
+			/*
+			 * One block of columns of one page row
+			 */
+			n = gText_step.x2 - gText_step.col + 1;
+			if(n > GLCD_BLKSIZE)
+				n = GLCD_BLKSIZE;
+			y2 = gText_step.y | 7;
+			if(y2 > gText_step.y2)
+				y2 = gText_step.y2;
+
+			if(gText_step.op == GLCD_STEP_FILL)
+				glcd_Device::SetPixels(gText_step.col, gText_step.y,
+					gText_step.col + n - 1, y2, gText_step.color);
+			else
+				glcd_Device::BitmapArea(gText_step.data, gText_step.bx, gText_step.by,
+					gText_step.col, gText_step.y, gText_step.col + n - 1, y2,
+					gText_step.color, GLCD_ROP_COPY);
+
+			gText_step.col += n;
+			if(gText_step.col > gText_step.x2)
+			{
+				/*
+				 * next page row
+				 */
+				gText_step.col = gText_step.x1;
+				gText_step.y = (gText_step.y | 7) + 1;
+				if(gText_step.y > gText_step.y2 || !gText_step.y)
+					gText_step.op = 0;
+			}
+		}
+		else
+		{
+			/*
+			 * One character of a string
+			 * A character that needs to wrap is wrapped first
+			 * so any scroll is done before the character is drawn.
+			 */
+			if(gText_step.op == GLCD_STEP_STRING_P)
+				c = pgm_read_byte(gText_step.data);
+			else
+				c = *gText_step.data;
+			if(!c)
+			{
+				gText_step.op = 0;
+				break;
+			}
+
+			gText_stepscroll = &gText_step.scroll;
+			if(c >= 0x20 && !gText_step.wrapped)
+			{
+				gText_step.text->StepWrap(c);
+				gText_step.wrapped = 1;
+			}
+			else
+			{
+				gText_nowrap = 1;
+				gText_step.text->PutChar(c);
+				gText_nowrap = 0;
+				gText_step.wrapped = 0;
+				gText_step.data++;
+			}
+			gText_stepscroll = 0;
+		}
+
+		if(micros() - start >= us)
+			break;
+	}
+	return(gText_step.op);
+}
+
+/**
+ * Start outputting a character string at x,y coordinate a piece at a time
+ *
+ * @param str pointer to a null terminated character string
+ * @param x specifies the horizontal location
+ * @param y specifies the vertical location
+ *
+ * Same as DrawString() except that the string is drawn by calls to Step().
+ * The string must not change until it has been drawn.
+ *
+ * @see Step()
+ * @see DrawString()
+ */
+
+void gText::StepDrawString(const char *str, uint8_t x, uint8_t y)
+{
+	while(this->Step(-1))	// finish previous operation before moving the cursor
+		;
+	this->CursorToXY(x,y);
+	this->StepStart(GLCD_STEP_STRING, 0, 0, 0, 0, 0, str);
+}
+
+/**
+ * Start outputting a program memory string at x,y coordinate a piece at a time
+ *
+ * @param str pointer to a null terminated character string stored in program memory
+ * @param x specifies the horizontal location
+ * @param y specifies the vertical location
+ *
+ * Same as DrawString_P() except that the string is drawn by calls to Step().
+ *
+ * @see Step()
+ * @see DrawString_P()
+ */
+
+void gText::StepDrawString_P(PGM_P str, uint8_t x, uint8_t y)
+{
+	while(this->Step(-1))	// finish previous operation before moving the cursor
+		;
+	this->CursorToXY(x,y);
+	this->StepStart(GLCD_STEP_STRING_P, 0, 0, 0, 0, 0, str);
+}
+
 /**
  * Positions cursor to a character based column and row.
  *
@@ -1470,6 +1816,7 @@ void gText::SelectFont(Font_t font,uint8_t color, FontCallback callback)
 	this->Font = font;
 	FontRead = callback;  // this sets the callback that will be used by all instances of gText
 	this->FontColor = color;
+	this->FontRop = GLCD_ROP_COPY;
 }
 
 /**
@@ -1487,6 +1834,29 @@ void gText::SetFontColor(uint8_t color)
    	this->FontColor = color;
 }
 
+/**
+ * Select how characters combine with the pixels under them
+ *
+ * @param rop raster op, GLCD_ROP_COPY, GLCD_ROP_OR, GLCD_ROP_AND, GLCD_ROP_XOR or GLCD_ROP_ANDNOT
+ *
+ * Characters are painted with the font color as a cell that includes the
+ * gap to the right and below. GLCD_ROP_COPY, which SelectFont() sets, replaces
+ * the pixels of the cell. With a BLACK font, GLCD_ROP_OR draws just the character
+ * over what is there, GLCD_ROP_XOR inverts the pixels under it, so printing
+ * the same text again in the same place erases it, and GLCD_ROP_ANDNOT clears them.
+ * See DrawBitmap() for the full details.
+ *
+ * @note The raster op is not used by the GLCD_OLD_FONTDRAW font rendering.
+ *
+ * @see SetFontColor()
+ * @see SelectFont()
+ */
+
+void gText::SetFontRop(uint8_t rop)
+{
+   	this->FontRop = rop;
+}
+
 /**
  * Set TextArea mode
  *
@@ -1609,7 +1979,7 @@ uint16_t gText::StringWidth_P(String &str)
 {
 	uint16_t width = 0;
 
-	for (int i = 0; i < str.length(); i++)
+	for (unsigned int i = 0; i < str.length(); i++)
 	{
 		width += this->CharWidth(str[i]);
 	}
@@ -33,8 +33,10 @@
 #include <avr/pgmspace.h>
 #include "glcd.h"
 #include "glcd_Config.h" 
-
-#define BITMAP_FIX // enables a bitmap rendering fix/patch
+#ifdef GLCD_FLUSH_ISR
+#include <avr/interrupt.h>
+#include "include/glcd_io.h"
+#endif
 
 
 glcd::glcd(){
@@ -74,6 +76,7 @@ int glcd::Init(uint8_t invert){
  *
  * Sets all the pixels on the display from 0,0 to GLCD.Width-1,GLCD.Height-1
  * to the specified color.
+ * When a clip area has been set, only the pixels inside it are set.
  *
  * Color is optional and defaults to WHITE.
  *
@@ -133,8 +136,34 @@ uint8_t t;\
 
 void glcd::DrawLine(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, uint8_t color)
 {
-uint8_t deltax, deltay, x,y, steep;
-int8_t error, ystep;
+uint8_t deltax, deltay, x,y, steep, lo, hi;
+int16_t error, k, kend, m, mend, t;
+int8_t ystep;
+uint8_t code1, code2;
+lineState_t line;
+
+	/*
+	 * A line with both ends beyond the same edge of the clip area
+	 * can't cross it (Cohen-Sutherland)
+	 */
+	code1 = this->ClipCode(x1, y1);
+	code2 = this->ClipCode(x2, y2);
+	if(code1 & code2)
+		return;
+
+	/*
+	 * Horizontal and vertical lines are filled as a span,
+	 * SetPixels() trims them to the clip area
+	 */
+	if(x1 == x2 || y1 == y2)
+	{
+		if(x1 > x2)
+			_GLCD_swap(x1, x2);
+		if(y1 > y2)
+			_GLCD_swap(y1, y2);
+		this->SetPixels(x1, y1, x2, y2, color);
+		return;
+	}
 
 #ifdef XXX
 	/*
@@ -170,13 +199,84 @@ int8_t error, ystep;
 
 	deltax = x2 - x1;
 	deltay =_GLCD_absDiff(y2,y1);  
-	error = deltax / 2;
-	y = y1;
 	if(y1 < y2) ystep = 1;  else ystep = -1;
 
-	for(x = x1; x <= x2; x++)
+	/*
+	 * Step k of the line is at x1+k, y1+m*ystep, where m is the number of
+	 * times the error went negative in the first k steps.
+	 * Work out the steps that land inside the clip area from that
+	 * rather than stepping through the pixels outside it.
+	 */
+	k = 0;
+	kend = deltax;
+	if(code1 | code2)
 	{
-		if (steep) this->SetDot(y,x, color); else this->SetDot(x,y, color);
+		if(steep)
+		{
+			lo = this->Clip.y1; hi = this->Clip.y2;
+		}
+		else
+		{
+			lo = this->Clip.x1; hi = this->Clip.x2;
+		}
+		if(x1 < lo)
+			k = lo - x1;
+		if(x2 > hi)
+			kend = hi - x1;
+
+		if(steep)
+		{
+			lo = this->Clip.x1; hi = this->Clip.x2;
+		}
+		else
+		{
+			lo = this->Clip.y1; hi = this->Clip.y2;
+		}
+		if(ystep > 0)
+		{
+			m = lo - y1; mend = hi - y1;
+		}
+		else
+		{
+			m = y1 - hi; mend = y1 - lo;
+		}
+		if(mend > deltay)
+			mend = deltay;
+		if(m > mend || mend < 0)
+			return;
+		if(m > 0)
+		{
+			t = ((uint16_t)(m-1) * deltax + deltax/2) / deltay + 1;	// first step at m
+			if(t > k)
+				k = t;
+		}
+		if(mend < deltay)
+		{
+			t = ((uint16_t)mend * deltax + deltax/2) / deltay;		// last step at mend
+			if(t < kend)
+				kend = t;
+		}
+		if(k > kend)
+			return;
+	}
+
+	m = 0;
+	if(k)
+		m = ((uint16_t)k * deltay + deltax - 1 - deltax/2) / deltax;
+	error = deltax/2 - k * deltay + m * deltax;
+	x = x1 + k;
+	y = y1 + m * ystep;
+
+	/*
+	 * The columns of a steep line move the same way as y
+	 */
+	line.n = 0;
+	line.color = color;
+	line.dir = steep ? ystep : 1;
+
+	for(; k <= kend; k++, x++)
+	{
+		if (steep) this->LinePixel(&line, y,x); else this->LinePixel(&line, x,y);
    		error = error - deltay;
 		if (error < 0)
 		{
@@ -184,6 +284,125 @@ int8_t error, ystep;
 			error = error + deltax;
     	}
 	}
+	this->LineFlush(&line);
+}
+
+/*
+ * Cohen-Sutherland outcode of a point:
+ * a bit for each edge of the clip area the point is beyond
+ */
+uint8_t glcd::ClipCode(uint8_t x, uint8_t y)
+{
+uint8_t code = 0;
+
+	if(x < this->Clip.x1)
+		code |= 1;
+	else if(x > this->Clip.x2)
+		code |= 2;
+	if(y < this->Clip.y1)
+		code |= 4;
+	else if(y > this->Clip.y2)
+		code |= 8;
+	return(code);
+}
+
+/*
+ * Add a pixel to the pixels of a line waiting to be set.
+ *
+ * Pixels are collected as long as they are in the same memory page
+ * and in the last column or the next column of the run.
+ * Any other pixel first sets the pixels collected so far.
+ * Pixels outside the clip area are ignored.
+ */
+void glcd::LinePixel(lineState_t *line, uint8_t x, uint8_t y)
+{
+	if((x < this->Clip.x1) || (x > this->Clip.x2) || (y < this->Clip.y1) || (y > this->Clip.y2))
+		return;
+
+	if(line->n && y/8 == line->page)
+	{
+		if(x == line->col)
+		{
+			line->buf[line->n-1] |= _BV(y%8);
+			return;
+		}
+		if(x == line->col + line->dir && line->n < GLCD_BLKSIZE)
+		{
+			line->col = x;
+			line->buf[line->n++] = _BV(y%8);
+			return;
+		}
+	}
+
+	this->LineFlush(line);
+	line->x = line->col = x;
+	line->page = y/8;
+	line->buf[0] = _BV(y%8);
+	line->n = 1;
+}
+
+/*
+ * Set the pixels of a line collected by LinePixel()
+ * with a single read-modify-write of the columns of the run.
+ */
+void glcd::LineFlush(lineState_t *line)
+{
+uint8_t i, mask, n = line->n;
+
+	if(!n)
+		return;
+
+	if(line->dir < 0)
+	{
+		/*
+		 * put the masks in left to right order
+		 */
+		for(i = 0; i < n/2; i++)
+		{
+			mask = line->buf[i];
+			line->buf[i] = line->buf[n-1-i];
+			line->buf[n-1-i] = mask;
+		}
+		this->WriteMasks(line->col, line->page * 8, line->buf, n, line->color);
+	}
+	else
+		this->WriteMasks(line->x, line->page * 8, line->buf, n, line->color);
+	line->n = 0;
+}
+
+/*
+ * Set (BLACK) or clear (WHITE) the pixels given by a bit mask for each of
+ * n columns starting at x in the page at y, y must be on a page boundary.
+ *
+ * This is a single block read-modify-write of the columns,
+ * or just a fill when every mask covers the whole byte.
+ */
+void glcd::WriteMasks(uint8_t x, uint8_t y, uint8_t *masks, uint8_t n, uint8_t color)
+{
+uint8_t data[GLCD_BLKSIZE];
+uint8_t i;
+
+	for(i = 0; i < n; i++)
+	{
+		if(masks[i] != 0xff)
+			break;
+	}
+	if(i == n)
+	{
+		this->SetPixels(x, y, x+n-1, y+7, color);
+		return;
+	}
+
+	this->GotoXY(x, y);
+	this->ReadDataBlock(data, n);
+	for(i = 0; i < n; i++)
+	{
+		if(color == BLACK)
+			data[i] |= masks[i];
+		else
+			data[i] &= ~masks[i];
+	}
+	this->WriteDataBlock(data, n);
 }
 
 /**
@@ -218,6 +437,15 @@ void glcd::DrawRect(uint8_t x, uint8_t y, uint8_t width, uint8_t height, uint8_t
 	DrawVLine(x+width, y, height, color);		// right
 }
 
+/*
+ * Check if any of the coordinates a to a+len are in lo to hi.
+ * Like the pixels drawn, a+len wraps around past 255.
+ */
+static uint8_t glcd_ClipSpan(uint8_t a, uint8_t len, uint8_t lo, uint8_t hi)
+{
+	return((uint8_t)(lo - a) <= len || (a >= lo && a <= hi));
+}
+
 /**
  * Draw a rectangle with rounder corners
  *
@@ -239,30 +467,74 @@ void glcd::DrawRect(uint8_t x, uint8_t y, uint8_t width, uint8_t height, uint8_t
 
 void glcd::DrawRoundRect(uint8_t x, uint8_t y, uint8_t width, uint8_t height, uint8_t radius, uint8_t color) {
   	int16_t tSwitch; 
-	uint8_t x1 = 0, y1 = radius;
-  	tSwitch = 3 - 2 * radius;
-	
-	while (x1 <= y1) {
-	    this->SetDot(x+radius - x1, y+radius - y1, color);
-	    this->SetDot(x+radius - y1, y+radius - x1, color);
-
-	    this->SetDot(x+width-radius + x1, y+radius - y1, color);
-	    this->SetDot(x+width-radius + y1, y+radius - x1, color);
-	    
-	    this->SetDot(x+width-radius + x1, y+height-radius + y1, color);
-	    this->SetDot(x+width-radius + y1, y+height-radius + x1, color);
-
-	    this->SetDot(x+radius - x1, y+height-radius + y1, color);
-	    this->SetDot(x+radius - y1, y+height-radius + x1, color);
-
-	    if (tSwitch < 0) {
-	    	tSwitch += (4 * x1 + 6);
-	    } else {
-	    	tSwitch += (4 * (x1 - y1) + 10);
-	    	y1--;
-	    }
-	    x1++;
+	uint8_t x1, y1;
+	uint8_t octant, xc, yc;
+	int8_t xs, ys;
+	lineState_t line;
+
+	/*
+	 * The corners are drawn an octant at a time so that the points of
+	 * the octant can be collected into whole bytes like the pixels of a line.
+	 * Octants 0-1 are the upper left corner, 2-3 upper right,
+	 * 4-5 lower left and 6-7 lower right.
+	 * In the odd octants x and y of the circle are swapped.
+	 */
+	if(!glcd_ClipSpan(x, width, this->Clip.x1, this->Clip.x2)
+		|| !glcd_ClipSpan(y, height, this->Clip.y1, this->Clip.y2))
+		return;
+
+	/*
+	 * Without a radius the sides meet at the corners (and the arc
+	 * below would run away as y1 goes below 0)
+	 */
+	line.n = 0;
+	line.color = color;
+	for(octant = 0; octant < 8 && radius; octant++)
+	{
+		if(octant & 2) {
+			xc = x+width-radius;
+			xs = 1;
+		} else {
+			xc = x+radius;
+			xs = -1;
+		}
+		if(octant & 4) {
+			yc = y+height-radius;
+			ys = 1;
+		} else {
+			yc = y+radius;
+			ys = -1;
+		}
+
+		/*
+		 * skip corners entirely outside the clip area
+		 */
+		if(!glcd_ClipSpan(xs > 0 ? xc : xc-radius, radius, this->Clip.x1, this->Clip.x2)
+			|| !glcd_ClipSpan(ys > 0 ? yc : yc-radius, radius, this->Clip.y1, this->Clip.y2))
+			continue;
+
+		this->LineFlush(&line);
+		line.dir = (octant & 1) ? -xs : xs;	// the way the columns of the octant go
+
+		x1 = 0;
+		y1 = radius;
+	  	tSwitch = 3 - 2 * radius;
+		while (x1 <= y1) {
+			if(octant & 1)
+				this->LinePixel(&line, xc + xs * y1, yc + ys * x1);
+			else
+				this->LinePixel(&line, xc + xs * x1, yc + ys * y1);
+
+		    if (tSwitch < 0) {
+		    	tSwitch += (4 * x1 + 6);
+		    } else {
+		    	tSwitch += (4 * (x1 - y1) + 10);
+		    	y1--;
+		    }
+		    x1++;
+		}
 	}
+	this->LineFlush(&line);
 	  	
 	this->DrawHLine(x+radius, y, width-(2*radius), color);			// top
 	this->DrawHLine(x+radius, y+height, width-(2*radius), color);	// bottom
@@ -278,6 +550,7 @@ void glcd::DrawRoundRect(uint8_t x, uint8_t y, uint8_t width, uint8_t height, ui
  * @param width width of the rectangle
  * @param height height of the rectangle
  * @param color BLACK or WHITE
+ * @param rop raster op, GLCD_ROP_COPY, GLCD_ROP_OR, GLCD_ROP_AND, GLCD_ROP_XOR or GLCD_ROP_ANDNOT
  *
  * Fills a rectanglular area of the specified width and height.
  *
@@ -292,6 +565,12 @@ void glcd::DrawRoundRect(uint8_t x, uint8_t y, uint8_t width, uint8_t height, ui
  *
  * Color is optional and defaults to BLACK.
  *
+ * The raster op says how the color combines with the pixels already there.
+ * It is optional and defaults to GLCD_ROP_COPY which sets the pixels to the color.
+ * With BLACK, GLCD_ROP_OR sets the pixels, GLCD_ROP_XOR inverts them
+ * and GLCD_ROP_ANDNOT clears them, while GLCD_ROP_AND leaves them alone.
+ * With WHITE, only GLCD_ROP_AND changes pixels, it clears them.
+ *
  * @note The width and height parameters work differently than DrawRect()
  *
  *
@@ -304,8 +583,29 @@ void glcd::DrawRoundRect(uint8_t x, uint8_t y, uint8_t width, uint8_t height, ui
  * @see InvertRect()
  */
 
-void glcd::FillRect(uint8_t x, uint8_t y, uint8_t width, uint8_t height, uint8_t color) {
-    this->SetPixels(x,y,x+width,y+height,color);
+void glcd::FillRect(uint8_t x, uint8_t y, uint8_t width, uint8_t height, uint8_t color, uint8_t rop) {
+uint8_t andbits = 0xff, orbits = 0, xorbits = 0;
+
+	switch(rop)
+	{
+	  case GLCD_ROP_COPY:
+		andbits = 0;
+		orbits = color;
+		break;
+	  case GLCD_ROP_OR:
+		orbits = color;
+		break;
+	  case GLCD_ROP_AND:
+		andbits = color;
+		break;
+	  case GLCD_ROP_XOR:
+		xorbits = color;
+		break;
+	  case GLCD_ROP_ANDNOT:
+		andbits = ~color;
+		break;
+	}
+	this->ModifyArea(x, y, x+width, y+height, andbits, orbits, xorbits);
 }
 
 /**
@@ -332,59 +632,7 @@ void glcd::FillRect(uint8_t x, uint8_t y, uint8_t width, uint8_t height, uint8_t
 
 
 void glcd::InvertRect(uint8_t x, uint8_t y, uint8_t width, uint8_t height) {
-	uint8_t mask, pageOffset, h, i, data, tmpData;
-	height++;
-	
-	pageOffset = y%8;
-	y -= pageOffset;
-	mask = 0xFF;
-	if(height < 8-pageOffset) {
-		mask >>= (8-height);
-		h = height;
-	} else {
-		h = 8-pageOffset;
-	}
-	mask <<= pageOffset;
-	
-	/*
-	 * First do the fractional pages at the top of the region
-	 */
-	glcd_Device::GotoXY(x, y);
-	for(i=0; i<=width; i++) {
-		data = this->ReadData();
-		tmpData = ~data;
-		data = (tmpData & mask) | (data & ~mask);
-		this->WriteData(data);
-	}
-	
-	/*
-	 * Now do the full pages
-	 */
-	while(h+8 <= height) {
-		h += 8;
-		y += 8;
-		glcd_Device::GotoXY(x, y);
-		
-		for(i=0; i<=width; i++) {
-			data = this->ReadData();
-			this->WriteData(~data);
-		}
-	}
-	
-	/*
-	 * Now do the fractional pages aat the bottom of the region
-	 */
-	if(h < height) {
-		mask = ~(0xFF << (height-h));
-		glcd_Device::GotoXY(x, y+8);
-		
-		for(i=0; i<=width; i++) {
-			data = this->ReadData();
-			tmpData = ~data;
-			data = (tmpData & mask) | (data & ~mask);
-			this->WriteData(data);
-		}
-	}
+	this->ModifyArea(x, y, x+width, y+height, 0xff, 0, 0xff);
 }
 /**
  * Set LCD Display mode
@@ -399,8 +647,13 @@ void glcd::InvertRect(uint8_t x, uint8_t y, uint8_t width, uint8_t height) {
 
 void glcd::SetDisplayMode(uint8_t invert) {  // was named SetInverted
 
+lcdClip clip;
+
 	if(this->Inverted != invert) {
+		clip = this->Clip;		// the whole display changes mode
+		this->ResetClipArea();
 		this->InvertRect(0,0,DISPLAY_WIDTH-1,DISPLAY_HEIGHT-1);
+		this->Clip = clip;
 		this->Inverted = invert;
 	}
 }
@@ -412,65 +665,79 @@ void glcd::SetDisplayMode(uint8_t invert) {  // was named SetInverted
  * @param x the x coordinate of the upper left corner of the bitmap
  * @param y the y coordinate of the upper left corner of the bitmap
  * @param color BLACK or WHITE
+ * @param rop raster op, GLCD_ROP_COPY, GLCD_ROP_OR, GLCD_ROP_AND, GLCD_ROP_XOR or GLCD_ROP_ANDNOT
  *
  * Draws a bitmap image with the upper left corner at location x,y
  * The bitmap data is assumed to be in program memory.
+ * Any y can be used and the height does not need to be a multiple of 8,
+ * only the pixels covered by the bitmap are changed.
+ * An x or y past the right or bottom of the display is taken as that many
+ * pixels less than 256 to the left or above it, so x = 256-8 draws the bitmap
+ * with its first 8 columns off the left edge.
  *
  * Color is optional and defaults to BLACK.
+ * With WHITE the bitmap is drawn inverted.
+ *
+ * The raster op says how the bitmap combines with the pixels already there.
+ * It is optional and defaults to GLCD_ROP_COPY which replaces them.
+ * GLCD_ROP_OR draws only the set pixels of the bitmap, GLCD_ROP_XOR inverts
+ * the display where the bitmap is set, so drawing it a second time erases it,
+ * GLCD_ROP_AND clears where the bitmap is clear and GLCD_ROP_ANDNOT clears
+ * where it is set (the bitmap can be used as a mask).
+ *
+ * The bitmap can also be compressed. A compressed bitmap starts with a 0
+ * where the width would be, followed by GLCD_BITMAP_PACKBITS, the width, the height,
+ * and then the bitmap data compressed with PackBits run length encoding.
+ * bmp2glcd -glcdlib -packbits creates them. The data is decoded
+ * as it is drawn, a byte at a time, so no memory is needed to hold it.
  *
-#ifdef NOTYET
  * @see DrawBitmapXBM()
-#endif
  */
 
-void glcd::DrawBitmap(Image_t bitmap, uint8_t x, uint8_t y, uint8_t color){
-uint8_t width, height;
-uint8_t i, j;
-
-  width = ReadPgmData(bitmap++); 
-  height = ReadPgmData(bitmap++);
-
-#ifdef BITMAP_FIX // temporary ifdef just to show what changes if a new 
-				// bit rendering routine is written.
-							
-  /*
-   * In the absence of a new/better/proper bitmap rendering routine,
-   * this routine will provide a temporary fix for drawing bitmaps that are
-   * are non multiples of 8 pixels in height and start on non LCD page Y addresses.
-   *
-   * Note: nomally a routine like this should not have knowledge of how
-   *	   how the lower level write routine works. But in this case it does.
-   *
-   *	Currently, the low level WriteData() routine ORs in the pixels when data spans
-   *	a LCD memory page. So.....
-   *
-   * In order to ensure that the bitmap data is written to the pixels *exactly* as it
-   * it defined in the bitmap data, i.e every black pixels is black and every white
-   * pixel is white,...
-   *
-   * If height or y coordinate is not on a page boundary, clear the background first
-   *	Techincally, this could be done all the time and it wouldn't hurt, it
-   *	would just suck up a few more cycles.
-   */
-  if( (y & 7) || (height & 7))
-  {
-  	this->FillRect(x, y, width, height, WHITE);
-  }
-#endif
-
-  for(j = 0; j < height / 8; j++) {
-     glcd_Device::GotoXY(x, y + (j*8) );
-	 for(i = 0; i < width; i++) {
-		 uint8_t displayData = ReadPgmData(bitmap++);
-	   	 if(color == BLACK)
-			this->WriteData(displayData);
-		 else
-		    this->WriteData(~displayData);
-	 }
-  }
+void glcd::DrawBitmap(Image_t bitmap, uint8_t x, uint8_t y, uint8_t color, uint8_t rop){
+  this->BitmapArea(bitmap, x, y, 0, 0, DISPLAY_WIDTH-1, DISPLAY_HEIGHT-1, color, rop);
 }
 
-#ifdef NOTYET
+/*
+ * Transpose an 8x8 bit matrix.
+ * On entry m[k] is row k with column j in bit j, on return m[j] is
+ * column j with row k in bit k, which is the layout of a glcd page.
+ *
+ * The rows are handled as two 32 bit words that are transposed with
+ * three rounds of bit swaps, exchanging 1x1, then 2x2, then 4x4 blocks,
+ * rather than moving the 64 bits one at a time.
+ * (see Hacker's Delight, 7-3 Transposing a Bit Matrix)
+ */
+static void glcd_Transpose8(uint8_t *m)
+{
+uint32_t x, y, t;
+
+	x = (uint32_t)m[0] | ((uint32_t)m[1] << 8) | ((uint32_t)m[2] << 16) | ((uint32_t)m[3] << 24);
+	y = (uint32_t)m[4] | ((uint32_t)m[5] << 8) | ((uint32_t)m[6] << 16) | ((uint32_t)m[7] << 24);
+
+	t = (x ^ (x >> 7)) & 0x00AA00AAUL;
+	x = x ^ t ^ (t << 7);
+	t = (y ^ (y >> 7)) & 0x00AA00AAUL;
+	y = y ^ t ^ (t << 7);
+
+	t = (x ^ (x >> 14)) & 0x0000CCCCUL;
+	x = x ^ t ^ (t << 14);
+	t = (y ^ (y >> 14)) & 0x0000CCCCUL;
+	y = y ^ t ^ (t << 14);
+
+	t = (y & 0xF0F0F0F0UL) | ((x >> 4) & 0x0F0F0F0FUL);
+	x = ((y << 4) & 0xF0F0F0F0UL) | (x & 0x0F0F0F0FUL);
+	y = t;
+
+	m[0] = x;
+	m[1] = x >> 8;
+	m[2] = x >> 16;
+	m[3] = x >> 24;
+	m[4] = y;
+	m[5] = y >> 8;
+	m[6] = y >> 16;
+	m[7] = y >> 24;
+}
 
 /**
  * Draw a glcd bitmap image in x11 XBM bitmap data format
@@ -486,6 +753,7 @@ uint8_t i, j;
  * The bitmap data is assumed to be in program memory.
  *
  * Color is optional and defaults to BLACK.
+ * With WHITE the bitmap is drawn inverted.
  *
  * @see DrawBitmapXBM_P()
  * @see DrawBitmap()
@@ -525,6 +793,9 @@ uint8_t *xbmbits;
  * The xbm bitmap pixel data format is the same as the X11 bitmap pixel data.
  * The bitmap data is assumed to be in program memory.
  *
+ * Like DrawBitmap() any x and y can be used, coordinates past the right or
+ * bottom of the display wrap around, and the bitmap is confined to the clip area.
+ *
  * @note All parameters are mandatory
  *
  * @see DrawBitmapXBM_P()
@@ -535,30 +806,91 @@ uint8_t *xbmbits;
 void glcd::DrawBitmapXBM_P(uint8_t width, uint8_t height, uint8_t *xbmbits, 
 			uint8_t x, uint8_t y, uint8_t fg_color, uint8_t bg_color)
 {
-uint8_t xbmx, xbmy;
-uint8_t xbmdata;
+uint8_t buf[GLCD_BLKSIZE];
+uint8_t cols[8];
+int16_t col, row, left, right, top, bottom, ox, oy, r, c;
+uint8_t stride, n, i, k, page, keep, data;
+int16_t xbmcol;
 
 	/*
-	 * Traverse through the XBM data byte by byte and plot pixel by pixel
+	 * XBM data is row major, each row is a run of bytes with the leftmost
+	 * pixel in bit 0. The display is page major, each byte is a column of 8 rows.
+	 * So the bitmap is drawn a display page at a time: the 8 XBM rows that
+	 * land in the page are read a byte (8 columns) at a time and transposed
+	 * into 8 page bytes, which are written out a block at a time like DrawBitmap() does.
+	 * The rows don't need to line up with the pages, the rows read are just
+	 * the ones that land in the page, and rows above or below the bitmap are 0.
 	 */
-	for(xbmy = 0; xbmy < height; xbmy++)
+	stride = (width + 7) / 8;
+	ox = x;
+	if(x >= DISPLAY_WIDTH)
+		ox -= 256;
+	oy = y;
+	if(y >= DISPLAY_HEIGHT)
+		oy -= 256;
+	left = ox;
+	right = ox + width - 1;
+	top = oy;
+	bottom = oy + height - 1;
+	if(left < this->Clip.x1)
+		left = this->Clip.x1;
+	if(right > this->Clip.x2)
+		right = this->Clip.x2;
+	if(top < this->Clip.y1)
+		top = this->Clip.y1;
+	if(bottom > this->Clip.y2)
+		bottom = this->Clip.y2;
+	if(left > right || top > bottom)
+		return;
+
+	for(page = top/8; page <= bottom/8; page++)
 	{
-		for(xbmx = 0; xbmx < width; xbmx++)
+		row = page*8;
+		keep = 0xff;
+		if(top > row)
+			keep <<= top - row;
+		if(bottom < row+7)
+			keep &= 0xff >> (row+7 - bottom);
+		row -= oy;		// bitmap row at the top of the page, can be above the bitmap
+
+		xbmcol = -1;	// XBM byte column held in cols[]
+		for(col = left; col <= right; col += n)
 		{
-			if(!(xbmx & 7))	// read the flash data only once per byte
-				xbmdata = ReadPgmData(xbmbits++);
-
-			if(xbmdata & _BV((xbmx & 7)))
-				this->SetDot(x+xbmx, y+xbmy, fg_color); // XBM 1 bits are fg color
-			else
-				this->SetDot(x+xbmx, y+xbmy, bg_color); // XBM 0 bits are bg color
+			n = GLCD_BLKSIZE;
+			if(n > right - col + 1)
+				n = right - col + 1;
+
+			glcd_Device::GotoXY(col, page*8);
+			if(keep != 0xff)
+				this->ReadDataBlock(buf, n);
+
+			for(i = 0; i < n; i++)
+			{
+				c = col + i - ox;	// bitmap column
+				if(c/8 != xbmcol)
+				{
+					xbmcol = c/8;
+					for(k = 0; k < 8; k++)
+					{
+						r = row + k;
+						if(r >= 0 && r < height)
+							cols[k] = ReadPgmData(xbmbits + r * stride + xbmcol);
+						else
+							cols[k] = 0;
+					}
+					glcd_Transpose8(cols);
+				}
+				data = cols[c & 7];
+				data = (data & fg_color) | (~data & bg_color);
+				if(keep != 0xff)
+					data = (buf[i] & ~keep) | (data & keep);
+				buf[i] = data;
+			}
+			this->WriteDataBlock(buf, n);
 		}
 	}
-
 }
 
-#endif // NOTYET
-
 // the following inline functions were added 2 Dec 2009 to replace macros
 
 /**
@@ -632,6 +964,17 @@ void glcd::DrawCircle(uint8_t xCenter, uint8_t yCenter, uint8_t radius, uint8_t
    this->DrawRoundRect(xCenter-radius, yCenter-radius, 2*radius, 2*radius, radius, color);
 }
 
+/*
+ * Note the half height h of column c of a filled circle
+ * when c is one of the n columns of the block starting at col.
+ */
+static void glcd_CircleHalf(uint8_t *half, int16_t col, uint8_t n, int16_t c, uint8_t h)
+{
+	c -= col;
+	if(c >= 0 && c < n && h > half[c])
+		half[c] = h;
+}
+
 /**
  * Draw a Filled in a Circle
  *
@@ -679,45 +1022,513 @@ void glcd::FillCircle(uint8_t xCenter, uint8_t yCenter, uint8_t radius, uint8_t
  *		For now, it is limited to circles.
  *
  * 			--- bperrybap
+ *
+ * The circle is a vertical span centered on yCenter in each column.
+ * Rather than drawing the spans as lines, the circle is done a block of
+ * columns at a time. The algorithm is run to get the half height of the
+ * span in each column of the block, then each page of the block is set
+ * with a single read-modify-write, or just a fill where the page is
+ * entirely inside the circle.
+ * Columns and rows that are outside the clip area are skipped.
  */
 
-int f = 1 - radius;
-int ddF_x = 1;
-int ddF_y = -2 * radius;
-uint8_t x = 0;
-uint8_t y = radius;
- 
-	/*
-	 * Fill in the center between the two halves
-	 */
-	DrawLine(xCenter, yCenter-radius, xCenter, yCenter+radius, color);
- 
-	while(x < y)
+uint8_t half[GLCD_BLKSIZE];
+uint8_t masks[GLCD_BLKSIZE];
+int16_t col, left, right, top, bottom, lo, hi;
+uint8_t n, i, s, e, page;
+int f, ddF_x, ddF_y;
+uint8_t x, y;
+
+	left = xCenter - radius;
+	if(left < this->Clip.x1)
+		left = this->Clip.x1;
+	right = xCenter + radius;
+	if(right > this->Clip.x2)
+		right = this->Clip.x2;
+	top = yCenter - radius;
+	if(top < this->Clip.y1)
+		top = this->Clip.y1;
+	bottom = yCenter + radius;
+	if(bottom > this->Clip.y2)
+		bottom = this->Clip.y2;
+	if(left > right || top > bottom)
+		return;
+
+	for(col = left; col <= right; col += n)
 	{
-    // ddF_x == 2 * x + 1;
-    // ddF_y == -2 * y;
-    // f == x*x + y*y - radius*radius + 2*x - y + 1;
-		if(f >= 0) 
+		n = GLCD_BLKSIZE;
+		if(n > right - col + 1)
+			n = right - col + 1;
+
+		for(i = 0; i < n; i++)
+			half[i] = 0;
+
+		f = 1 - radius;
+		ddF_x = 1;
+		ddF_y = -2 * radius;
+		x = 0;
+		y = radius;
+
+		/*
+		 * The center column between the two halves
+		 */
+		glcd_CircleHalf(half, col, n, xCenter, radius);
+
+		while(x < y)
 		{
-			y--;
-			ddF_y += 2;
-			f += ddF_y;
+	    // ddF_x == 2 * x + 1;
+	    // ddF_y == -2 * y;
+	    // f == x*x + y*y - radius*radius + 2*x - y + 1;
+			if(f >= 0) 
+			{
+				y--;
+				ddF_y += 2;
+				f += ddF_y;
+			}
+			x++;
+			ddF_x += 2;
+			f += ddF_x;    
+
+			/*
+			 * The spans between the points on the upper and lower quadrants
+			 * of the 2 halves of the circle.
+			 */
+			glcd_CircleHalf(half, col, n, xCenter+x, y);
+			glcd_CircleHalf(half, col, n, xCenter-x, y);
+			glcd_CircleHalf(half, col, n, xCenter+y, x);
+			glcd_CircleHalf(half, col, n, xCenter-y, x);
+	  	}
+
+		for(page = top/8; page <= bottom/8; page++)
+		{
+			for(i = 0; i < n; i++)
+			{
+				lo = yCenter - half[i];
+				if(lo < page*8)
+					lo = page*8;
+				if(lo < top)
+					lo = top;
+				hi = yCenter + half[i];
+				if(hi > page*8+7)
+					hi = page*8+7;
+				if(hi > bottom)
+					hi = bottom;
+				if(lo <= hi)
+					masks[i] = (uint8_t)(0xff >> (7 - (hi - lo))) << (lo - page*8);
+				else
+					masks[i] = 0;
+			}
+
+			/*
+			 * leave out the columns at the ends that have nothing to set
+			 */
+			for(s = 0; s < n && !masks[s]; s++)
+				;
+			for(e = n; e > s && !masks[e-1]; e--)
+				;
+			if(s < e)
+				this->WriteMasks(col + s, page*8, masks + s, e - s, color);
 		}
-		x++;
-		ddF_x += 2;
-		f += ddF_x;    
+	}
+}
+
+/*
+ * Polygons are filled glcd_POLYBLK columns at a time with the
+ * pixels of all the pages of the columns built up in a buffer.
+ */
+#define glcd_POLYBLK	8
+#define glcd_POLYPAGES	((DISPLAY_HEIGHT+7)/8)
+
+/*
+ * Set (or toggle when toggle is nonzero) rows y1 to y2
+ * of column i in the buffer of a polygon fill.
+ */
+static void glcd_PolyRows(uint8_t masks[][glcd_POLYBLK], uint8_t i, int16_t y1, int16_t y2, uint8_t toggle)
+{
+uint8_t page, bits;
+int16_t lo, hi;
+
+	for(page = y1/8; page <= y2/8; page++)
+	{
+		lo = y1 > page*8 ? y1 : page*8;
+		hi = y2 < page*8+7 ? y2 : page*8+7;
+		bits = (uint8_t)(0xff >> (7 - (hi - lo))) << (lo - page*8);
+		if(toggle)
+			masks[page][i] ^= bits;
+		else
+			masks[page][i] |= bits;
+	}
+}
+
+/*
+ * Add the polygon edge from x0,y0 to x1,y1 to the n columns starting at col
+ * in the buffer of a polygon fill. Rows below bottom are left out.
+ *
+ * When toggle is nonzero the pixels below the point where the edge crosses
+ * the center of a column are toggled. Once all the edges are toggled, the
+ * pixels inside the polygon have been toggled an odd number of times.
+ * An edge crosses the column of its left end but not the column of its
+ * right end, so a vertex between two edges is only crossed once
+ * when the edges go the same way.
+ *
+ * Otherwise the pixels that DrawLine() would set for the edge are set.
+ * This is done once all the edges are toggled so the edges
+ * are not toggled off again.
+ */
+static void glcd_PolyEdge(uint8_t masks[][glcd_POLYBLK], int16_t col, uint8_t n, int16_t bottom,
+	int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint8_t toggle)
+{
+int32_t slope, y;
+int16_t x, t, k, kend, m, mend, du, dv, err;
+int8_t ystep;
+uint8_t steep;
+
+	if(toggle)
+	{
+		if(x0 > x1)
+		{
+			t = x0; x0 = x1; x1 = t;
+			t = y0; y0 = y1; y1 = t;
+		}
+		x = x0 > col ? x0 : col;
+		t = x1 < col+n ? x1 : col+n;	// the right end is not crossed
+		if(x >= t)
+			return;
 
 		/*
-		 * Now draw vertical lines between the points on the circle rather than
-		 * draw the points of the circle. This draws lines between the 
-		 * perimeter points on the upper and lower quadrants of the 2 halves of the circle.
+		 * y is where the edge crosses the center of column x in 16.16 fixed point
 		 */
+		slope = ((int32_t)(y1 - y0) << 16) / (x1 - x0);
+		y = ((int32_t)y0 << 16) + (x - x0) * slope;
+		for(; x < t; x++, y += slope)
+		{
+			k = (y >> 16) + 1;
+			if(k <= bottom)
+				glcd_PolyRows(masks, x-col, k, bottom, 1);
+		}
+		return;
+	}
+
+	/*
+	 * Run the line algorithm of DrawLine() over the part of the edge in the
+	 * columns, starting it part way along the line where needed.
+	 * k counts the steps along the line and m the steps across it.
+	 */
+	steep = _GLCD_absDiff(y0, y1) > _GLCD_absDiff(x0, x1);
+	if(steep)
+	{
+		t = x0; x0 = y0; y0 = t;
+		t = x1; x1 = y1; y1 = t;
+	}
+	if(x0 > x1)
+	{
+		t = x0; x0 = x1; x1 = t;
+		t = y0; y0 = y1; y1 = t;
+	}
+	du = x1 - x0;
+	dv = _GLCD_absDiff(y0, y1);
+	ystep = y0 < y1 ? 1 : -1;
+
+	if(steep)
+	{
+		/*
+		 * the columns are across the line
+		 */
+		m = (col - y0) * ystep;
+		mend = (col + n - 1 - y0) * ystep;
+		if(m > mend)
+		{
+			t = m; m = mend; mend = t;
+		}
+		if(m < 0)
+			m = 0;
+		if(mend > dv)
+			mend = dv;
+		if(m > mend)
+			return;
+		k = m ? ((int32_t)(m-1) * du + du/2) / dv + 1 : 0;
+		kend = du;
+	}
+	else
+	{
+		k = col > x0 ? col - x0 : 0;
+		kend = col + n - 1 - x0 < du ? col + n - 1 - x0 : du;
+		if(k > kend)
+			return;
+		mend = dv;
+	}
+	m = 0;
+	if((int32_t)k * dv > du/2)
+		m = ((int32_t)k * dv - du/2 + du - 1) / du;
+	err = du/2 - (int32_t)k * dv + (int32_t)m * du;
+
+	for(; k <= kend && m <= mend; k++)
+	{
+		if(steep)
+		{
+			x = y0 + m * ystep;
+			t = x0 + k;
+			if(t > bottom)
+				break;
+		}
+		else
+		{
+			x = x0 + k;
+			t = y0 + m * ystep;
+		}
+		if(t <= bottom)
+			masks[t/8][x-col] |= _BV(t%8);
 
-		DrawLine(xCenter+x, yCenter+y, xCenter+x, yCenter-y, color);
-		DrawLine(xCenter-x, yCenter+y, xCenter-x, yCenter-y, color);
-		DrawLine(xCenter+y, yCenter+x, y+xCenter, yCenter-x, color);
-		DrawLine(xCenter-y, yCenter+x, xCenter-y, yCenter-x, color);
-  	}
+		err -= dv;
+		if(err < 0)
+		{
+			m++;
+			err += du;
+		}
+	}
+}
+
+/**
+ * Fill a Polygon
+ *
+ * @param points x,y pairs of the corners of the polygon
+ * @param count the number of corners
+ * @param color BLACK or WHITE
+ *
+ * Fills the polygon formed by joining the corners in order
+ * and then joining the last corner back to the first.
+ * The edges between the corners are filled as well, so the filled polygon
+ * covers the same pixels as an outline of it drawn with DrawLine().
+ * Where the edges of the polygon cross each other, areas
+ * that are inside an even number of times are not filled.
+ *
+ * The polygon is filled a few columns at a time. The pixels of every page of
+ * the columns are worked out first and then each page is written with a
+ * single read-modify-write, or just a fill where the page is entirely inside
+ * the polygon. Parts of the polygon that are outside the clip area are skipped.
+ *
+ * Color is optional and defaults to BLACK.
+ *
+ * @see FillTriangle()
+ * @see DrawLine()
+ */
+
+void glcd::FillPolygon(const uint8_t *points, uint8_t count, uint8_t color)
+{
+uint8_t masks[glcd_POLYPAGES][glcd_POLYBLK];
+int16_t col, left, right, top, bottom;
+uint8_t n, i, j, s, e, page;
+
+	if(!count)
+		return;
+
+	left = right = points[0];
+	top = bottom = points[1];
+	for(i = 1; i < count; i++)
+	{
+		if(points[2*i] < left)
+			left = points[2*i];
+		if(points[2*i] > right)
+			right = points[2*i];
+		if(points[2*i+1] < top)
+			top = points[2*i+1];
+		if(points[2*i+1] > bottom)
+			bottom = points[2*i+1];
+	}
+	if(left < this->Clip.x1)
+		left = this->Clip.x1;
+	if(right > this->Clip.x2)
+		right = this->Clip.x2;
+	if(top < this->Clip.y1)
+		top = this->Clip.y1;
+	if(bottom > this->Clip.y2)
+		bottom = this->Clip.y2;
+	if(left > right || top > bottom)
+		return;
+
+	for(col = left; col <= right; col += n)
+	{
+		n = glcd_POLYBLK;
+		if(n > right - col + 1)
+			n = right - col + 1;
+
+		for(page = top/8; page <= bottom/8; page++)
+		{
+			for(i = 0; i < n; i++)
+				masks[page][i] = 0;
+		}
+
+		for(i = 0, j = count-1; i < count; j = i++)
+		{
+			glcd_PolyEdge(masks, col, n, bottom,
+				points[2*j], points[2*j+1], points[2*i], points[2*i+1], 1);
+		}
+		for(i = 0, j = count-1; i < count; j = i++)
+		{
+			glcd_PolyEdge(masks, col, n, bottom,
+				points[2*j], points[2*j+1], points[2*i], points[2*i+1], 0);
+		}
+
+		for(page = top/8; page <= bottom/8; page++)
+		{
+			/*
+			 * drop any rows above the clip area,
+			 * the edges stop at the bottom on their own
+			 */
+			if(page == top/8)
+			{
+				for(i = 0; i < n; i++)
+					masks[page][i] &= 0xff << (top%8);
+			}
+
+			/*
+			 * leave out the columns at the ends that have nothing to set
+			 */
+			for(s = 0; s < n && !masks[page][s]; s++)
+				;
+			for(e = n; e > s && !masks[page][e-1]; e--)
+				;
+			if(s < e)
+				this->WriteMasks(col + s, page*8, masks[page] + s, e - s, color);
+		}
+	}
+}
+
+/**
+ * Fill a Triangle
+ *
+ * @param x1 X coordinate of the first corner
+ * @param y1 Y coordinate of the first corner
+ * @param x2 X coordinate of the second corner
+ * @param y2 Y coordinate of the second corner
+ * @param x3 X coordinate of the third corner
+ * @param y3 Y coordinate of the third corner
+ * @param color BLACK or WHITE
+ *
+ * Fills the triangle with the given corners including its edges.
+ * See FillPolygon() for the full details.
+ *
+ * Color is optional and defaults to BLACK.
+ *
+ * @see FillPolygon()
+ */
+
+void glcd::FillTriangle(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, uint8_t x3, uint8_t y3, uint8_t color)
+{
+uint8_t points[6];
+
+	points[0] = x1;
+	points[1] = y1;
+	points[2] = x2;
+	points[3] = y2;
+	points[4] = x3;
+	points[5] = y3;
+	this->FillPolygon(points, 3, color);
+}
+
+/**
+ * Start clearing the lcd display a piece at a time
+ *
+ * @param color BLACK or WHITE
+ *
+ * Same as ClearScreen() except that the pixels are set by calls to Step().
+ * The text position is homed right away.
+ *
+ * Color is optional and defaults to WHITE.
+ *
+ * @note Other drawing done before Step() completes can be overwritten.
+ *
+ * @see Step()
+ * @see ClearScreen()
+ */
+
+void glcd::StepClearScreen(uint8_t color)
+{
+	this->StepStart(GLCD_STEP_FILL, 0, 0, GLCD.Width-1, GLCD.Height-1, color, 0);
+ 	CursorToXY(0,0);  // home text position
+}
+
+/**
+ * Start filling a Rectangle a piece at a time
+ * 
+ * @param x the x coordinate of the upper left corner of the rectangle
+ * @param y the y coordinate of the upper left corner of the rectangle
+ * @param width width of the rectangle
+ * @param height height of the rectangle
+ * @param color BLACK or WHITE
+ *
+ * Same as FillRect() except that the pixels are set by calls to Step().
+ *
+ * Color is optional and defaults to BLACK.
+ *
+ * @see Step()
+ * @see FillRect()
+ */
+
+void glcd::StepFillRect(uint8_t x, uint8_t y, uint8_t width, uint8_t height, uint8_t color)
+{
+	this->StepStart(GLCD_STEP_FILL, x, y, x+width, y+height, color, 0);
+}
+
+/**
+ * Start drawing a glcd bitmap image a piece at a time
+ *
+ * @param bitmap a ponter to the bitmap data
+ * @param x the x coordinate of the upper left corner of the bitmap
+ * @param y the y coordinate of the upper left corner of the bitmap
+ * @param color BLACK or WHITE
+ *
+ * Same as DrawBitmap() except that the image is drawn by calls to Step(),
+ * a block of columns of a page at a time. Any y can be used and the height
+ * does not need to be a multiple of 8, the pages at the top and bottom that
+ * are partly covered keep the pixels around the bitmap just like DrawBitmap().
+ * Only the part of the bitmap inside the clip area is drawn.
+ *
+ * Color is optional and defaults to BLACK.
+ *
+ * @note A compressed bitmap is drawn right away with DrawBitmap().
+ *
+ * @see Step()
+ * @see DrawBitmap()
+ */
+
+void glcd::StepDrawBitmap(Image_t bitmap, uint8_t x, uint8_t y, uint8_t color)
+{
+uint8_t width, height;
+int16_t left, right, top, bottom;
+
+	width = ReadPgmData(bitmap); 
+	height = ReadPgmData(bitmap+1);
+
+	if(!width)
+	{
+		this->DrawBitmap(bitmap, x, y, color);
+		return;
+	}
+
+	/*
+	 * Step() goes over the part of the bitmap inside the clip area
+	 */
+	left = x;
+	if(x >= DISPLAY_WIDTH)
+		left -= 256;
+	top = y;
+	if(y >= DISPLAY_HEIGHT)
+		top -= 256;
+	right = left + width - 1;
+	bottom = top + height - 1;
+	if(left < this->Clip.x1)
+		left = this->Clip.x1;
+	if(right > this->Clip.x2)
+		right = this->Clip.x2;
+	if(top < this->Clip.y1)
+		top = this->Clip.y1;
+	if(bottom > this->Clip.y2)
+		bottom = this->Clip.y2;
+	if(left > right || top > bottom)
+		return;
+
+	this->StepStart(GLCD_STEP_BITMAP, left, top, right, bottom, color, bitmap, x, y);
 }
 
 	
@@ -746,4 +1557,16 @@ void glcd::GotoXY(uint8_t x, uint8_t y)
 
 // Make one instance for the user
 glcd GLCD = glcd();
+
+#ifdef GLCD_FLUSH_ISR
+/*
+ * Background flush timer interrupt, started by Init().
+ * Interrupts are enabled while it runs so that it doesn't hold off
+ * millis() and serial interrupts while it talks to the glcd.
+ */
+ISR(lcdFlushTimerVect, ISR_NOBLOCK)
+{
+	GLCD.FlushStep(GLCD_FLUSH_ISR_BYTES);
+}
+#endif
  
@@ -49,9 +49,29 @@
 typedef const uint8_t* Image_t; // a glcd format bitmap (includes width & height)
 typedef const uint8_t* ImageXBM_t; // a "xbm" format bitmap (includes width & height)
 
-// the first two bytes of bitmap data are the width and height
-#define bitmapWidth(bitmap)  (*bitmap)  
-#define bitmapHeight(bitmap)  (*(bitmap+1))  
+// the first two bytes of bitmap data are the width and height (the 3rd and 4th when compressed)
+// bitmaps are in program memory
+#define bitmapWidth(bitmap)  (ReadPgmData(bitmap) ? ReadPgmData(bitmap) : ReadPgmData((bitmap)+2))  
+#define bitmapHeight(bitmap)  (ReadPgmData(bitmap) ? ReadPgmData((bitmap)+1) : ReadPgmData((bitmap)+3))  
+
+#include "include/gSprite.h"
+
+/// @cond hide_from_doxygen
+/*
+ * Pixels of a line that are waiting to be set, collected as a bit mask
+ * for each column of a run of adjacent columns in one memory page.
+ */
+typedef struct
+{
+	uint8_t x;			// first column of the run
+	uint8_t col;		// last column of the run
+	int8_t dir;			// columns of the run go right (1) or left (-1)
+	uint8_t page;
+	uint8_t n;			// columns in the run
+	uint8_t color;
+	uint8_t buf[GLCD_BLKSIZE];
+} lineState_t;
+/// @endcond
 
 
 /**
@@ -61,6 +81,10 @@ typedef const uint8_t* ImageXBM_t; // a "xbm" format bitmap (includes width & he
 class glcd : public gText  
 {
   private:
+	void LinePixel(lineState_t *line, uint8_t x, uint8_t y);
+	void LineFlush(lineState_t *line);
+	void WriteMasks(uint8_t x, uint8_t y, uint8_t *masks, uint8_t n, uint8_t color);
+	uint8_t ClipCode(uint8_t x, uint8_t y);
   public:
 	glcd();
 	
@@ -84,16 +108,19 @@ class glcd : public gText
 	void DrawLine(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, uint8_t color= BLACK);
 	void DrawRect(uint8_t x, uint8_t y, uint8_t width, uint8_t height, uint8_t color= BLACK);
 	void DrawRoundRect(uint8_t x, uint8_t y, uint8_t width, uint8_t height, uint8_t radius, uint8_t color= BLACK);
-	void FillRect(uint8_t x, uint8_t y, uint8_t width, uint8_t height, uint8_t color= BLACK);
+	void FillRect(uint8_t x, uint8_t y, uint8_t width, uint8_t height, uint8_t color= BLACK, uint8_t rop= GLCD_ROP_COPY);
 	void InvertRect(uint8_t x, uint8_t y, uint8_t width, uint8_t height);
 	void DrawCircle(uint8_t xCenter, uint8_t yCenter, uint8_t radius, uint8_t color= BLACK);	
 	void FillCircle(uint8_t xCenter, uint8_t yCenter, uint8_t radius, uint8_t color= BLACK);	
-	void DrawBitmap(Image_t bitmap, uint8_t x, uint8_t y, uint8_t color= BLACK);
-#ifdef NOTYET
+	void FillTriangle(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, uint8_t x3, uint8_t y3, uint8_t color= BLACK);
+	void FillPolygon(const uint8_t *points, uint8_t count, uint8_t color= BLACK);
+	void DrawBitmap(Image_t bitmap, uint8_t x, uint8_t y, uint8_t color= BLACK, uint8_t rop= GLCD_ROP_COPY);
+	void StepClearScreen(uint8_t color = WHITE);
+	void StepFillRect(uint8_t x, uint8_t y, uint8_t width, uint8_t height, uint8_t color= BLACK);
+	void StepDrawBitmap(Image_t bitmap, uint8_t x, uint8_t y, uint8_t color= BLACK);
 	void DrawBitmapXBM(ImageXBM_t bitmapxbm, uint8_t x, uint8_t y, uint8_t color= BLACK);
 	void DrawBitmapXBM_P(uint8_t width, uint8_t height, uint8_t *xbmbits, uint8_t x, uint8_t y, 
 		uint8_t fg_color, uint8_t bg_color);
-#endif
 
 #ifdef DOXYGEN
 	/*
@@ -102,13 +129,43 @@ class glcd : public gText
 	 */
 	void SetDot(uint8_t x, uint8_t y, uint8_t color);
 	void SetPixels(uint8_t x, uint8_t y,uint8_t x1, uint8_t y1, uint8_t color);
+	void SetClipArea(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2);
+	void ResetClipArea(void);
 	uint8_t ReadData(void);        // now public
     void WriteData(uint8_t data); 
+	void WriteDataBlock(const uint8_t *src, uint8_t len, uint8_t color=BLACK);
+	void WriteDataBlock_P(const uint8_t *src, uint8_t len, uint8_t color=BLACK);
+	void ReadDataBlock(uint8_t *dst, uint8_t len);
+	void Flush(void);
+	uint16_t FlushStep(uint16_t count);
+	void WaitFlush(void);
+	uint16_t FlushPending(void);
+	uint16_t FlushPeak(void);
+	void StatsBegin(glcdStats_t *stats);
+	void StatsEnd(glcdStats_t *stats);
+	void SwapBuffers(void);
 #else
 	using glcd_Device::SetDot;
 	using glcd_Device::SetPixels;
+	using glcd_Device::SetClipArea;
+	using glcd_Device::ResetClipArea;
 	using glcd_Device::ReadData; 
 	using glcd_Device::WriteData; 
+	using glcd_Device::WriteDataBlock;
+	using glcd_Device::WriteDataBlock_P;
+	using glcd_Device::ReadDataBlock;
+	using glcd_Device::Flush;
+	using glcd_Device::FlushStep;
+	using glcd_Device::WaitFlush;
+	using glcd_Device::FlushPending;
+	using glcd_Device::FlushPeak;
+#ifdef GLCD_STATS
+	using glcd_Device::StatsBegin;
+	using glcd_Device::StatsEnd;
+#endif
+#ifdef GLCD_DOUBLE_BUFFER
+	using glcd_Device::SwapBuffers;
+#endif
 #endif
 
 
@@ -65,6 +65,7 @@
   */
 #include "config/ks0108_Panel.h"          // automatically configure library for a ks0108 panel
 //#include "config/ks0108-192x64_Panel.h"   // automatically configure library for a ks0108 192x64 panel
+//#include "config/ks0108-128x32_Panel.h"   // automatically configure library for a ks0108 128x32 panel
 
 /*
  * If you want to explicitly select a manual configuration, you can edit the desired manual configuration
@@ -96,6 +97,21 @@
 
 //#define GLCD_NODEFER_SCROLL    // uncomment to disable deferred newline processing
 
+//#define GLCD_NOXCOL_SUPPORT    // uncomment to disable tracking the column of each glcd chip
+                                // Tracking the column avoids sending set column commands
+                                // when the glcd chip is already at the desired column.
+                                // Disabling it saves 1 byte of RAM per chip and a little code.
+
+//#define GLCD_NO_HWSCROLL      // uncomment to disable scrolling the whole display with the display start line
+                                // A text area that covers the whole display normally scrolls by
+                                // moving the display start line when the scroll is a multiple of 8 pixels
+                                // (for example the System5x7 font) and the device supports it.
+
+//#define GLCD_DOUBLE_BUFFER    // uncomment to draw into a second frame in glcd memory shown by SwapBuffers()
+                                // Only for modules whose chips have memory for twice the display height
+                                // (for example a 32 line display on ks0108 chips, see config/ks0108-128x32_Panel.h)
+                                // and cannot be used with GLCD_READ_CACHE, GLCD_WRITE_BACK or GLCD_WRITE_ONLY.
+
 //#define GLCD_NOINIT_CHECKS	// uncommont to remove initialization busy status checks
 				// this turns off the code in the low level init code that
 				// checks for a module stuck BUSY or stuck in RESET.
@@ -110,4 +126,37 @@
 				// performance increase is quite noticeable (double or so on FPS test)
 				// This will not work on smaller AVRs like the mega168 that only
 				// have 1k of RAM total.
+
+//#define GLCD_WRITE_BACK       // Turns on write back mode (this also turns on GLCD_READ_CACHE)
+				// Drawing only updates the frame buffer and marks what changed.
+				// Nothing is sent to the display until GLCD.Flush() is called
+				// at which point only the bytes that changed are written.
+				// Uses the same RAM as GLCD_READ_CACHE.
+
+//#define GLCD_FLUSH_ISR        // Turns on the background flush (this also turns on GLCD_WRITE_BACK)
+				// A timer interrupt sends up to GLCD_FLUSH_ISR_BYTES (default 16)
+				// changed bytes to the display about every millisecond,
+				// so drawing functions never wait on the display.
+				// GLCD.WaitFlush() waits for the display to catch up.
+				// The interrupt shares timer0 with millis() so no timer is used up.
+
+//#define GLCD_WRITE_ONLY       // Turns on write only mode for modules with the R/W pin tied low
+				// The glcd is never read, not even its busy status.
+				// Instead of polling for busy, the code waits GLCD_tBUSY nanoseconds
+				// before each access. The default GLCD_tBUSY is in the device file
+				// and can be overridden in the panel config file.
+				// All reads come from the frame buffer (this also turns on GLCD_READ_CACHE)
+				// and glcdRW does not have to be defined in the config file.
+				// The initialization busy/reset status checks are not done.
+
+//#define GLCD_STATS            // Turns on counting of the glcd bus transactions of each chip
+				// GLCD.StatsBegin()/GLCD.StatsEnd() report the counts between them
+				// so the cost of drawing calls can be measured.
+				// Costs a little time on every access and 28 bytes of RAM per chip.
+
+//#define GLCD_BUSY_PROFILE     // Adds a histogram of how long each chip stayed busy to the
+				// GLCD_STATS counts (this also turns on GLCD_STATS).
+				// The busy time is counted in passes of the busy wait loop
+				// and is kept separately for busy after a command, a data write
+				// and a data read. Uses another 96 bytes of RAM per chip.
 #endif
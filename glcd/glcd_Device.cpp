@@ -27,6 +27,10 @@
 #include "include/glcd_Device.h"
 #include "include/glcd_io.h"
 #include "include/glcd_errno.h"
+#include <avr/pgmspace.h>
+#ifdef GLCD_FLUSH_ISR
+#include <util/atomic.h>
+#endif
 
 
 /*
@@ -35,6 +39,7 @@
 
 uint8_t	 glcd_Device::Inverted; 
 lcdCoord  glcd_Device::Coord;
+lcdClip   glcd_Device::Clip = {0, 0, DISPLAY_WIDTH-1, DISPLAY_HEIGHT-1};
 
 /*
  * Experimental defines
@@ -86,10 +91,6 @@ lcdCoord  glcd_Device::Coord;
 							// teensy GLCD adapter board which has a very slow rising reset pulse.
 
 
-//#define GLCD_XCOL_SUPPORT	//turns on code to track the hardware X/column to minimize set column commands.
-							// Believe it or not, the code on the ks0108s runs slower with this
-							// enabled.
-
 
 #ifdef GLCD_READ_CACHE
 /*
@@ -98,6 +99,167 @@ lcdCoord  glcd_Device::Coord;
 uint8_t glcd_rdcache[DISPLAY_HEIGHT/8][DISPLAY_WIDTH];
 #endif
 
+/*
+ * flags for WriteBlock()
+ */
+#define GLCD_BLK_PGM	1	// source data is in program memory
+#define GLCD_BLK_FILL	2	// source is a single byte to repeat
+#define GLCD_BLK_INVERT	4	// write inverted source data (WHITE)
+
+#ifdef GLCD_BROADCAST
+/*
+ * Columns that every chip has, the last chip can be narrower
+ */
+#define glcd_BCAST_WIDTH	(DISPLAY_WIDTH - (glcd_CHIP_COUNT-1) * CHIP_WIDTH)
+#endif
+
+#ifdef GLCD_XCOL_SUPPORT
+/*
+ * Track the column auto increment of a chip after a data read or write.
+ * The hardware column is lost when the device doesn't say how its
+ * column counter behaves or once it has been lost.
+ */
+#ifdef glcd_DevColInc
+#define glcd_ColInc(c)										\
+do															\
+{															\
+	if(Coord.chip[c].col != 0xff)							\
+		Coord.chip[c].col = glcd_DevColInc(Coord.chip[c].col);	\
+} while(0)
+#else
+#define glcd_ColInc(c)	(Coord.chip[c].col = -1)
+#endif
+#endif
+
+/*
+ * Use the hardware read-modify-write mode on devices that support it.
+ * With a read cache, reads never go to the hardware so there is no point.
+ */
+#if defined(glcd_DevRMWmode) && !defined(GLCD_READ_CACHE) && !defined(GLCD_NO_RMW)
+#define GLCD_RMW
+
+/*
+ * Chips currently in rmw mode (bit per chip) and the location
+ * of the last ReadData() used to detect sequential read-modify-writes.
+ */
+static uint8_t glcd_rmwchips;
+static uint8_t glcd_rdx, glcd_rdy;
+#endif
+
+#ifdef GLCD_WRITE_BACK
+/*
+ * Dirty column bitmap of each page in the frame buffer.
+ * A set bit is a column that must be sent to the glcd on the next Flush().
+ */
+static uint8_t glcd_dirty[DISPLAY_HEIGHT/8][(DISPLAY_WIDTH+7)/8];
+
+#define glcd_IsDirty(page, x) (glcd_dirty[page][(x)/8] & _BV((x)%8))
+
+/*
+ * Largest run of clean columns that Flush() will rewrite rather than
+ * re-address around. A column address costs one command on most chips
+ * and two on chips with split low/high column address commands.
+ * Since a data write costs about the same as a command write, a gap up
+ * to this size is cheaper to rewrite than to skip.
+ */
+#ifndef GLCD_FLUSH_GAP
+#ifdef LCD_SET_ADDLO
+#define GLCD_FLUSH_GAP 2
+#else
+#define GLCD_FLUSH_GAP 1
+#endif
+#endif
+
+/*
+ * Dirty bytes waiting to be sent and the most there have been since the
+ * last FlushPeak().
+ */
+static uint16_t glcd_dirtycount;
+static uint16_t glcd_dirtypeak;
+
+/*
+ * FlushStep() scans each page with a separate lane for the columns of
+ * each chip and takes turns between the lanes, so a chip is written
+ * while the others are still busy from their last write.
+ * glcd_flushcol[] is the next column of each lane relative to its first
+ * column, glcd_flushlane is the lane that goes next, and glcd_flushpage
+ * the page being scanned.
+ */
+#define glcd_FLUSH_LANES	((DISPLAY_WIDTH + CHIP_WIDTH - 1) / CHIP_WIDTH)
+#define glcd_LaneWidth(lane)	((lane) < glcd_FLUSH_LANES-1 ? CHIP_WIDTH : DISPLAY_WIDTH - (glcd_FLUSH_LANES-1) * CHIP_WIDTH)
+
+static uint8_t glcd_flushpage, glcd_flushlane;
+static uint8_t glcd_flushcol[glcd_FLUSH_LANES];
+#endif
+
+#ifdef GLCD_FLUSH_ISR
+/*
+ * glcd_flushlock is set while someone is talking to the glcd hardware
+ * so the timer interrupt leaves the hardware alone.
+ */
+static volatile uint8_t glcd_flushlock;
+
+/*
+ * The dirty bookkeeping is shared with the interrupt
+ */
+#define glcd_FlushAtomic() ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+#elif defined(GLCD_WRITE_BACK)
+#define glcd_FlushAtomic()
+#endif
+
+#ifdef GLCD_HWSCROLL
+/*
+ * Display memory page shown at the top of the display.
+ * Page y/8 of the display is in memory page (y/8 + glcd_startpage) % pages.
+ */
+static uint8_t glcd_startpage;
+#endif
+
+#ifdef GLCD_DOUBLE_BUFFER
+/*
+ * First memory page of the frame that drawing goes to.
+ * The other frame is the one being displayed.
+ */
+static uint8_t glcd_drawpage;
+#endif
+
+#ifdef GLCD_STATS
+/*
+ * Running bus transaction counts,
+ * StatsBegin()/StatsEnd() report the difference.
+ */
+static glcdStats_t glcd_stats;
+#define glcd_StatsInc(c, count) (glcd_stats.chip[c].count++)
+#else
+#define glcd_StatsInc(c, count)
+#endif
+
+#ifdef GLCD_BUSY_PROFILE
+/*
+ * The last kind of access to each chip, which is what a busy wait
+ * before the next access is charged to.
+ */
+static uint8_t glcd_busyop[glcd_CHIP_COUNT];
+#define glcd_BusyOp(c, op) (glcd_busyop[c] = op)
+
+/*
+ * Add a busy wait of the given number of wait loop passes to the histogram
+ */
+static void glcd_BusyRecord(uint8_t chip, uint16_t spins)
+{
+uint8_t bucket = 0;
+
+	while(spins && bucket < GLCD_BUSY_BUCKETS-1)
+	{
+		spins >>= 1;
+		bucket++;
+	}
+	glcd_stats.chip[chip].busy[glcd_busyop[chip]][bucket]++;
+}
+#else
+#define glcd_BusyOp(c, op)
+#endif
+
 	
 glcd_Device::glcd_Device(){
   
@@ -113,7 +275,8 @@ glcd_Device::glcd_Device(){
  * Sets the pixel at location x,y to the specified color.
  * x and y are relative to the 0,0 origin of the display which
  * is the upper left corner.
- * Requests to set pixels outside the range of the display will be ignored.
+ * Requests to set pixels outside the clip area, which is the whole display
+ * unless SetClipArea() has been called, will be ignored.
  *
  * @note If the display has been set to INVERTED mode then the colors
  * will be automically reversed.
@@ -124,7 +287,7 @@ void glcd_Device::SetDot(uint8_t x, uint8_t y, uint8_t color)
 {
 	uint8_t data;
 
-	if((x >= DISPLAY_WIDTH) || (y >= DISPLAY_HEIGHT))
+	if((x < this->Clip.x1) || (x > this->Clip.x2) || (y < this->Clip.y1) || (y > this->Clip.y2))
 		return;
 	
 	this->GotoXY(x, y-y%8);					// read data from display memory
@@ -153,6 +316,8 @@ void glcd_Device::SetDot(uint8_t x, uint8_t y, uint8_t color)
  * The width of the area is x2-x + 1. 
  * The height of the area is y2-y+1 
  * 
+ * Only the part of the area inside the clip area is set.
+ * An x2 or y2 less than x or y extends the area to the right or bottom edge.
  *
  */
 
@@ -161,9 +326,46 @@ void glcd_Device::SetDot(uint8_t x, uint8_t y, uint8_t color)
 
 void glcd_Device::SetPixels(uint8_t x, uint8_t y,uint8_t x2, uint8_t y2, uint8_t color)
 {
-uint8_t mask, pageOffset, h, i, data;
-uint8_t height = y2-y+1;
-uint8_t width = x2-x+1;
+	this->ModifyArea(x, y, x2, y2, 0, color, 0);
+}
+
+/*
+ * Read-modify-write the pixels of the area bounded by x,y to x2,y2 inclusive
+ * that are inside the clip area, x2 and y2 work like they do for SetPixels().
+ *
+ * Each pixel is updated to ((pixel & andbits) | orbits) ^ xorbits.
+ * Whole pages are just filled when the result does not depend on the data.
+ */
+void glcd_Device::ModifyArea(uint8_t x, uint8_t y, uint8_t x2, uint8_t y2, uint8_t andbits, uint8_t orbits, uint8_t xorbits)
+{
+uint8_t mask, pageOffset, h;
+uint8_t height, width;
+uint8_t fill = orbits ^ xorbits;	// the data of whole pages when andbits is 0
+
+	if(andbits == 0xff && !orbits && !xorbits)
+		return;
+
+	/*
+	 * Trim the area to the clip area, which is never larger than the display
+	 * so nothing is written off the display where GotoXY() does not go.
+	 */
+	if(x2 < x)
+		x2 = 255;
+	if(y2 < y)
+		y2 = 255;
+	if(x < this->Clip.x1)
+		x = this->Clip.x1;
+	if(y < this->Clip.y1)
+		y = this->Clip.y1;
+	if(x2 > this->Clip.x2)
+		x2 = this->Clip.x2;
+	if(y2 > this->Clip.y2)
+		y2 = this->Clip.y2;
+	if((x > x2) || (y > y2))
+		return;
+
+	height = y2-y+1;
+	width = x2-x+1;
 	
 	pageOffset = y%8;
 	y -= pageOffset;
@@ -176,44 +378,322 @@ uint8_t width = x2-x+1;
 	}
 	mask <<= pageOffset;
 	
-	this->GotoXY(x, y);
-	for(i=0; i < width; i++) {
-		data = this->ReadData();
-		
-		if(color == BLACK) {
-			data |= mask;
-		} else {
-			data &= ~mask;
-		}
-
-		this->WriteData(data);
+	if(h == 8 && !andbits) {
+		/*
+		 * the first page is entirely set, fill it like the ones below
+		 */
+		this->GotoXY(x, y);
+		this->WriteBlock(&fill, width, GLCD_BLK_FILL);
+	} else {
+		this->ModifyData(x, y, width, andbits | ~mask, orbits & mask, xorbits & mask);
 	}
 	
 	while(h+8 <= height) {
 		h += 8;
 		y += 8;
-		this->GotoXY(x, y);
-		
-		for(i=0; i <width; i++) {
-			this->WriteData(color);
+		if(!andbits) {
+			this->GotoXY(x, y);
+			this->WriteBlock(&fill, width, GLCD_BLK_FILL);
+		} else {
+			this->ModifyData(x, y, width, andbits, orbits, xorbits);
 		}
 	}
 	
 	if(h < height) {
 		mask = ~(0xFF << (height-h));
-		this->GotoXY(x, y+8);
-		
-		for(i=0; i < width; i++) {
-			data = this->ReadData();
-		
-			if(color == BLACK) {
-				data |= mask;
-			} else {
-				data &= ~mask;
+		this->ModifyData(x, y+8, width, andbits | ~mask, orbits & mask, xorbits & mask);
+	}
+}
+
+/**
+ * Confine drawing to an area of the display
+ *
+ * @param x1 X coordinate of upper left corner
+ * @param y1 Y coordinate of upper left corner
+ * @param x2 X coordinate of lower right corner
+ * @param y2 Y coordinate of lower right corner
+ *
+ * Pixels outside the area bounded by x1,y1 to x2,y2 inclusive are left
+ * alone by the drawing functions and text output until ResetClipArea() is called.
+ * Each drawing function works out the part of the shape inside the area
+ * up front, so drawing shapes that are mostly or entirely outside it
+ * costs little.
+ *
+ * The area is trimmed to the display.
+ * If x2 is less than x1 or y2 less than y1 nothing is drawn.
+ *
+ * @note The data functions (ReadData(), WriteData(), WriteDataBlock(), ...), text area
+ * scrolling and the GLCD_OLD_FONTDRAW font rendering are not clipped.
+ *
+ * @see ResetClipArea()
+ */
+void glcd_Device::SetClipArea(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2)
+{
+	if(x2 >= DISPLAY_WIDTH)
+		x2 = DISPLAY_WIDTH-1;
+	if(y2 >= DISPLAY_HEIGHT)
+		y2 = DISPLAY_HEIGHT-1;
+	this->Clip.x1 = x1;
+	this->Clip.y1 = y1;
+	this->Clip.x2 = x2;
+	this->Clip.y2 = y2;
+}
+
+/**
+ * Allow drawing on the whole display
+ *
+ * @see SetClipArea()
+ */
+void glcd_Device::ResetClipArea(void)
+{
+	this->SetClipArea(0, 0, DISPLAY_WIDTH-1, DISPLAY_HEIGHT-1);
+}
+
+/*
+ * Start the next run of PackBits data.
+ * A code of 0 to 127 is followed by 1 to 128 literal bytes, a code of 129 to 255
+ * is followed by one byte that is repeated 128 to 2 times, 128 is a no-op.
+ */
+static void glcd_UnpackRun(unpackState_t *unpack)
+{
+uint8_t code;
+
+	do
+	{
+		code = pgm_read_byte(unpack->src++);
+		if(code < 128)
+		{
+			unpack->count = code + 1;
+			unpack->repeat = 0;
+		}
+		else if(code > 128)
+		{
+			unpack->count = 257 - code;
+			unpack->repeat = 1;
+			unpack->data = pgm_read_byte(unpack->src++);
+		}
+	} while(code == 128);
+}
+
+/*
+ * Start decoding the compressed data of a bitmap, the bytes after its header.
+ * The decoder only goes ahead, glcd_UnpackSeek() skips to the next byte wanted
+ * and glcd_UnpackByte() returns it, so a pass over the bitmap decodes it just once.
+ */
+void glcd_UnpackStart(unpackState_t *unpack, const uint8_t *data)
+{
+	unpack->src = data;
+	unpack->pos = 0;
+	unpack->count = 0;
+}
+
+uint8_t glcd_UnpackByte(unpackState_t *unpack)
+{
+	if(!unpack->count)
+		glcd_UnpackRun(unpack);
+	unpack->count--;
+	unpack->pos++;
+	if(unpack->repeat)
+		return(unpack->data);
+	return(pgm_read_byte(unpack->src++));
+}
+
+/*
+ * Skip ahead to offset pos of the bitmap data, a run at a time
+ */
+void glcd_UnpackSeek(unpackState_t *unpack, uint16_t pos)
+{
+uint16_t n;
+
+	while(unpack->pos < pos)
+	{
+		if(!unpack->count)
+			glcd_UnpackRun(unpack);
+		n = pos - unpack->pos;
+		if(n > unpack->count)
+			n = unpack->count;
+		unpack->count -= n;
+		unpack->pos += n;
+		if(!unpack->repeat)
+			unpack->src += n;
+	}
+}
+
+/*
+ * Draw the part of a glcd bitmap with its upper left corner at x,y that is
+ * in the area bounded by x1,y1 to x2,y2 inclusive and inside the clip area.
+ * x and y past the right or bottom of the display wrap like they do for DrawBitmap().
+ *
+ * The bitmap is drawn a page of the display at a time. Each display byte
+ * is put together from the one or two bitmap bytes that land in it, shifted
+ * into place, and written just once. Only on the pages at the top and bottom
+ * that are partly covered, or when the raster op needs the pixels already
+ * there, is the display read.
+ */
+void glcd_Device::BitmapArea(const uint8_t *bitmap, uint8_t x, uint8_t y,
+	uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, uint8_t color, uint8_t rop)
+{
+uint8_t width, height;
+uint8_t buf[GLCD_BLKSIZE];
+int16_t col, row, left, right, top, bottom, ox, oy;
+uint8_t n, i, page, keep, data, shift, packed;
+const uint8_t *src;
+unpackState_t unpack[3];	// decoders of the bitmap pages for the top and bottom of a page, and the next top
+
+	width = pgm_read_byte(bitmap++);
+	packed = 0;
+	if(!width)
+	{
+		packed = pgm_read_byte(bitmap++);
+		if(packed != GLCD_BITMAP_PACKBITS)
+			return;
+		width = pgm_read_byte(bitmap++);
+	}
+	height = pgm_read_byte(bitmap++);
+	if(packed)
+	{
+		for(i = 0; i < 3; i++)
+			glcd_UnpackStart(&unpack[i], bitmap);
+	}
+
+	if(x1 < this->Clip.x1)
+		x1 = this->Clip.x1;
+	if(y1 < this->Clip.y1)
+		y1 = this->Clip.y1;
+	if(x2 > this->Clip.x2)
+		x2 = this->Clip.x2;
+	if(y2 > this->Clip.y2)
+		y2 = this->Clip.y2;
+
+	ox = x;
+	if(x >= DISPLAY_WIDTH)
+		ox -= 256;
+	oy = y;
+	if(y >= DISPLAY_HEIGHT)
+		oy -= 256;
+	left = ox;
+	right = ox + width - 1;
+	top = oy;
+	bottom = oy + height - 1;
+	if(left < x1)
+		left = x1;
+	if(right > x2)
+		right = x2;
+	if(top < y1)
+		top = y1;
+	if(bottom > y2)
+		bottom = y2;
+	if(left > right || top > bottom)
+		return;
+
+	for(page = top/8; page <= bottom/8; page++)
+	{
+		row = page*8;
+		keep = 0xff;
+		if(top > row)
+			keep <<= top - row;
+		if(bottom < row+7)
+			keep &= 0xff >> (row+7 - bottom);
+		row -= oy;		// bitmap row at the top of the page, can be above the bitmap
+		shift = row & 7;
+
+		if(row >= 0 && !shift && keep == 0xff && rop == GLCD_ROP_COPY && !packed)
+		{
+			/*
+			 * A whole page of the bitmap going to a whole page of the display
+			 * is the bitmap data as is, so write it straight out of flash.
+			 */
+			this->GotoXY(left, page*8);
+			this->WriteDataBlock_P(bitmap + (row/8) * width + (left - ox), right - left + 1, color);
+			continue;
+		}
+
+		if(packed)
+		{
+			/*
+			 * The compressed data can only be decoded going ahead, a bitmap page after
+			 * another. When the bitmap isn't on a page boundary each bitmap page lands
+			 * in the bottom of one page and the top of the next, so the decoder is
+			 * copied at the start of the bottom to decode the same bytes for the next top.
+			 */
+			if(row >= 0)
+				glcd_UnpackSeek(&unpack[0], (row/8) * width + (left - ox));
+			if(shift && (row < 0 || (row/8+1)*8 < height))
+			{
+				glcd_UnpackSeek(&unpack[1], (row < 0 ? 0 : row/8+1) * width + (left - ox));
+				unpack[2] = unpack[1];
 			}
-	
-			this->WriteData(data);
 		}
+
+		for(col = left; col <= right; col += n)
+		{
+			n = GLCD_BLKSIZE;
+			if(n > right - col + 1)
+				n = right - col + 1;
+
+			this->GotoXY(col, page*8);
+			if(keep != 0xff || rop != GLCD_ROP_COPY)
+				this->ReadDataBlock(buf, n);
+
+			src = bitmap + (col - ox);
+			if(row >= 0)
+				src += (row/8) * width;
+			for(i = 0; i < n; i++, src++)
+			{
+				if(row < 0)
+					data = (packed ? glcd_UnpackByte(&unpack[1]) : pgm_read_byte(src)) << -row;
+				else
+				{
+					data = (packed ? glcd_UnpackByte(&unpack[0]) : pgm_read_byte(src)) >> shift;
+					if(shift && (row/8+1)*8 < height)
+						data |= (packed ? glcd_UnpackByte(&unpack[1]) : pgm_read_byte(src + width)) << (8 - shift);
+				}
+				if(color == WHITE)
+					data = ~data;
+				if(rop != GLCD_ROP_COPY)
+					data = this->RopData(rop, data, buf[i]);
+				if(keep != 0xff)
+					data = (buf[i] & ~keep) | (data & keep);
+				buf[i] = data;
+			}
+			this->WriteDataBlock(buf, n);
+		}
+		if(packed && shift)
+			unpack[0] = unpack[2];
+	}
+}
+
+/*
+ * Read-modify-write width columns of the page at x,y
+ *
+ * y must be on a page boundary.
+ * Each byte is updated to ((data & andbits) | orbits) ^ xorbits
+ * a block of columns at a time.
+ * The read is skipped when the result does not depend on the data.
+ */
+void glcd_Device::ModifyData(uint8_t x, uint8_t y, uint8_t width, uint8_t andbits, uint8_t orbits, uint8_t xorbits)
+{
+uint8_t buf[GLCD_BLKSIZE];
+uint8_t n, i;
+
+	while(width && x < DISPLAY_WIDTH)
+	{
+		n = GLCD_BLKSIZE;
+		if(n > width)
+			n = width;
+		if(n > DISPLAY_WIDTH - x)
+			n = DISPLAY_WIDTH - x;
+
+		this->GotoXY(x, y);
+		if((uint8_t)(~andbits | orbits) != 0xff)
+			this->ReadDataBlock(buf, n);
+
+		for(i = 0; i < n; i++)
+			buf[i] = ((buf[i] & andbits) | orbits) ^ xorbits;
+
+		this->WriteDataBlock(buf, n);
+		x += n;
+		width -= n;
 	}
 }
 
@@ -230,8 +710,6 @@ uint8_t width = x2-x+1;
 
 void glcd_Device::GotoXY(uint8_t x, uint8_t y)
 {
-  uint8_t chip, cmd;
-
   if((x == this->Coord.x) && (y == this->Coord.y))
 	return;
 
@@ -239,25 +717,62 @@ void glcd_Device::GotoXY(uint8_t x, uint8_t y)
   {
     return;
   }
+  glcd_StatsInc(glcd_DevXYval2Chip(x, y), gotoxy);
 
   this->Coord.x = x;								// save new coordinates
   this->Coord.y = y;
 
+#ifndef GLCD_WRITE_BACK
+  /*
+   * In write back mode the glcd hardware is only positioned by Flush()
+   */
+  this->DoGotoXY(x, y);
+#endif
+}
+
+/*
+ * position the glcd hardware to x,y
+ *
+ * The s/w coordinates are not modified.
+ */
+void glcd_Device::DoGotoXY(uint8_t x, uint8_t y)
+{
+  uint8_t chip, cmd;
+
   chip = glcd_DevXYval2Chip(x, y);
 
+#ifdef GLCD_RMW
+	if(glcd_rmwchips & _BV(chip))
+	{
+		/*
+		 * Ending rmw mode puts the column back to where it was when
+		 * the mode started, so the column must always be set below.
+		 */
+		this->WriteCommand(LCD_RMW_END, chip);
+		glcd_rmwchips &= ~_BV(chip);
+#ifdef GLCD_XCOL_SUPPORT
+		this->Coord.chip[chip].col = -1;
+#endif
+	}
+#endif
+
 	if(y/8 != this->Coord.chip[chip].page)
 	{
   		this->Coord.chip[chip].page = y/8;
+#if defined(GLCD_HWSCROLL)
+		cmd = LCD_SET_PAGE | ((y/8 + glcd_startpage) % (DISPLAY_HEIGHT/8));
+#elif defined(GLCD_DOUBLE_BUFFER)
+		cmd = LCD_SET_PAGE | (y/8 + glcd_drawpage);
+#else
 		cmd = LCD_SET_PAGE | this->Coord.chip[chip].page;
+#endif
 	   	this->WriteCommand(cmd, chip);	
 	}
 	
 	/*
-	 * NOTE: For now, the "if" below is intentionally commented out.
-	 * In order for this to work, the code must properly track
-	 * the x coordinate of the chips and not allow it go beyond proper
-	 * boundaries. It isnn't complicated to do, it jsut isn't done that
-	 * way right now.
+	 * With GLCD_XCOL_SUPPORT the hardware column of each chip is tracked
+	 * through the column auto increment of reads and writes,
+	 * so the set column can be skipped when the chip is already there.
 	 */
 
 	x = glcd_DevXval2ChipCol(x);
@@ -283,43 +798,171 @@ void glcd_Device::GotoXY(uint8_t x, uint8_t y)
 #endif
 	}
 }
-/**
- * Low level h/w initialization of display and AVR pins
- *
- * @param invert specifices whether display is in normal mode or inverted mode.
- *
- * This should only be called by other library code.
- *
- * It does all the low level hardware initalization of the display device.
- *
- * The optional invert parameter specifies if the display should be run in a normal
- * mode, dark pixels on light background or inverted, light pixels on a dark background.
- *
- * To specify dark pixels use the define @b NON-INVERTED and to use light pixels use
- * the define @b INVERTED
- *
- * @returns 0 when successful or non zero error code when unsucessful
- *
- * Upon successful completion of the initialization, the entire display will be cleared
- * and the x,y postion will be set to 0,0
- *
- * @note
- * This function can be called more than once 
- * to re-initliaze the hardware.
- *
+
+#if defined(GLCD_HWSCROLL) || defined(GLCD_DOUBLE_BUFFER)
+/*
+ * Set the display start line of all the chips
  */
+void glcd_Device::SetStartLine(uint8_t line)
+{
+uint8_t chip;
 
+	for(chip = 0; chip < glcd_CHIP_COUNT; chip++)
+	{
+#ifdef GLCD_RMW
+		if(glcd_rmwchips & _BV(chip))
+		{
+			this->WriteCommand(LCD_RMW_END, chip);
+			glcd_rmwchips &= ~_BV(chip);
+#ifdef GLCD_XCOL_SUPPORT
+			this->Coord.chip[chip].col = -1;
+#endif
+		}
+#endif
+		this->WriteCommand(glcd_DevStartLine(line), chip);
 
-int glcd_Device::Init(uint8_t invert)
-{  
+		/*
+		 * The page address of the chip is now a different display page
+		 */
+		this->Coord.chip[chip].page = -1;
+	}
 
+#ifndef GLCD_WRITE_BACK
 	/*
-	 * Now setup the pinmode for all of our control pins.
-	 * The data lines will be configured as necessary when needed.
+	 * put the hardware back at the current location
 	 */
+	if(this->Coord.x < DISPLAY_WIDTH)
+		this->DoGotoXY(this->Coord.x, this->Coord.y);
+#endif
+}
+#endif
 
-	lcdPinMode(glcdDI,OUTPUT);	
-	lcdPinMode(glcdRW,OUTPUT);	
+#ifdef GLCD_HWSCROLL
+#ifdef GLCD_READ_CACHE
+/*
+ * Rotate the pages of a page by page array so that each page gets
+ * what was in the page that is the given number of pages below it.
+ */
+static void glcd_RotatePages(uint8_t *buf, uint8_t rowsize, uint8_t pages)
+{
+uint8_t tmp[DISPLAY_HEIGHT/8];
+uint8_t i, page;
+
+	for(i = 0; i < rowsize; i++)
+	{
+		for(page = 0; page < DISPLAY_HEIGHT/8; page++)
+			tmp[page] = buf[page * rowsize + i];
+		for(page = 0; page < DISPLAY_HEIGHT/8; page++)
+			buf[page * rowsize + i] = tmp[(page + pages) % (DISPLAY_HEIGHT/8)];
+	}
+}
+#endif
+
+/*
+ * Scroll the entire display up by the given number of memory pages,
+ * or down when negative, by moving the display start line.
+ *
+ * Only a start line command is sent to each chip. The rows that scroll
+ * in at the other edge show what scrolled out, so the caller has to
+ * clear them.
+ */
+void glcd_Device::ScrollPages(int8_t pages)
+{
+	pages = (pages + DISPLAY_HEIGHT/8) % (DISPLAY_HEIGHT/8);	// same scroll, upwards
+	if(!pages)
+		return;
+
+#ifdef GLCD_FLUSH_ISR
+	glcd_flushlock = 1;	// keep the background flush away while things move
+#endif
+
+	glcd_startpage = (glcd_startpage + pages) % (DISPLAY_HEIGHT/8);
+
+#ifdef GLCD_READ_CACHE
+	/*
+	 * The frame buffer is by display page so it has to move along with
+	 * the display. In write back mode the changes that are not sent yet
+	 * move with it so they still go to the right place.
+	 */
+	glcd_RotatePages(glcd_rdcache[0], DISPLAY_WIDTH, pages);
+#ifdef GLCD_WRITE_BACK
+	glcd_RotatePages(glcd_dirty[0], sizeof(glcd_dirty[0]), pages);
+#endif
+#endif
+
+	this->SetStartLine(glcd_startpage * 8);
+
+#ifdef GLCD_FLUSH_ISR
+	glcd_flushlock = 0;
+#endif
+}
+#endif
+
+#ifdef GLCD_DOUBLE_BUFFER
+/**
+ * Show the frame that was drawn and draw on the other one
+ *
+ * All drawing goes to a frame in glcd memory that is not displayed.
+ * SwapBuffers() displays it by moving the display start line and
+ * makes the frame that was displayed the one drawn on.
+ * A complete new frame is shown at once without any host memory.
+ *
+ * @note The frame drawn on after the swap still holds the frame
+ * from before the previous swap, not what is now displayed.
+ * Sketches that update only part of the display should either redraw
+ * it entirely or draw each change twice, once per frame.
+ */
+void glcd_Device::SwapBuffers(void)
+{
+uint8_t line = glcd_drawpage * 8;
+
+	glcd_drawpage = glcd_drawpage ? 0 : DISPLAY_HEIGHT/8;
+	this->SetStartLine(line);
+}
+#endif
+/**
+ * Low level h/w initialization of display and AVR pins
+ *
+ * @param invert specifices whether display is in normal mode or inverted mode.
+ *
+ * This should only be called by other library code.
+ *
+ * It does all the low level hardware initalization of the display device.
+ *
+ * The optional invert parameter specifies if the display should be run in a normal
+ * mode, dark pixels on light background or inverted, light pixels on a dark background.
+ *
+ * To specify dark pixels use the define @b NON-INVERTED and to use light pixels use
+ * the define @b INVERTED
+ *
+ * @returns 0 when successful or non zero error code when unsucessful
+ *
+ * Upon successful completion of the initialization, the entire display will be cleared
+ * and the x,y postion will be set to 0,0
+ *
+ * @note
+ * This function can be called more than once 
+ * to re-initliaze the hardware.
+ *
+ */
+
+
+int glcd_Device::Init(uint8_t invert)
+{  
+
+#ifdef GLCD_FLUSH_ISR
+	glcd_flushlock = 1;	// keep the background flush off the hardware
+#endif
+
+	/*
+	 * Now setup the pinmode for all of our control pins.
+	 * The data lines will be configured as necessary when needed.
+	 */
+
+	lcdPinMode(glcdDI,OUTPUT);	
+#ifdef glcdRW
+	lcdPinMode(glcdRW,OUTPUT);	
+#endif
 
 #ifdef glcdE1
 	lcdPinMode(glcdE1,OUTPUT);	
@@ -332,7 +975,7 @@ int glcd_Device::Init(uint8_t invert)
 
 #ifdef glcdEN
 	lcdPinMode(glcdEN,OUTPUT);	
-	lcdfastWrite(glcdEN, LOW);
+	glcd_DevENstrobeLo(0);		// EN is not active high on all devices
 #endif
 
 #ifdef glcdCSEL1
@@ -364,12 +1007,18 @@ int glcd_Device::Init(uint8_t invert)
 
 
 	lcdfastWrite(glcdDI, LOW);
+#ifdef glcdRW
 	lcdfastWrite(glcdRW, LOW);
+#endif
+#ifdef GLCD_WRITE_ONLY
+	lcdDataDir(0xFF);	// data port is only ever an output
+#endif
 
 	this->Coord.x = -1;  // invalidate the s/w coordinates so the first GotoXY() works
 	this->Coord.y = -1;  // invalidate the s/w coordinates so the first GotoXY() works
 	
 	this->Inverted = invert;
+	this->ResetClipArea();	// the display is cleared below through the clip area
 
 #ifdef glcdRES
 	/*
@@ -402,42 +1051,63 @@ int glcd_Device::Init(uint8_t invert)
 
 	for(uint8_t chip=0; chip < glcd_CHIP_COUNT; chip++)
 	{
-	uint8_t status;
-
-#ifndef GLCD_NOINIT_CHECKS
+#if !defined(GLCD_NOINIT_CHECKS) && !defined(GLCD_WRITE_ONLY)
 		/*
 		 * At this point RESET better be complete and the glcd better have
 		 * cleared BUSY status for the chip and be ready to go.
 		 * So we check them and if the GLCD chip is not ready to go, we fail the init.
 		 */
+		{
+		uint8_t status = this->GetStatus(chip);
 
-		status = this->GetStatus(chip);
-		if(lcdIsResetStatus(status))
-			return(GLCD_ERESET);
-		if(lcdIsBusyStatus(status))
-			return(GLCD_EBUSY);
+			if(lcdIsResetStatus(status))
+				return(GLCD_ERESET);
+			if(lcdIsBusyStatus(status))
+				return(GLCD_EBUSY);
+		}
 #endif
 			
 		/*
 		 * flush out internal state to force first GotoXY() to talk to GLCD hardware
 		 */
 		this->Coord.chip[chip].page = -1;
+#ifdef GLCD_RMW
+		glcd_rmwchips = 0;
+		glcd_rdx = -2;	// no previous read
+#endif
 #ifdef GLCD_XCOL_SUPPORT
 		this->Coord.chip[chip].col = -1;
 #endif
 
 #ifdef glcd_DeviceInit // this provides custom chip specific init 
+		{
+		uint8_t status = glcd_DeviceInit(chip);	// call device specific initialization if defined    
 
-		status = glcd_DeviceInit(chip);	// call device specific initialization if defined    
-		if(status)
-			return(status);
+			if(status)
+				return(status);
+		}
 #else
 		this->WriteCommand(LCD_ON, chip);			// display on
 		this->WriteCommand(LCD_DISP_START, chip);	// display start line = 0
 #endif
+#ifdef GLCD_HWSCROLL
+		glcd_startpage = 0;
+#endif
 
 	}
 
+#ifdef GLCD_DOUBLE_BUFFER
+	/*
+	 * Clear the frame being displayed, then leave drawing on the other one
+	 */
+	glcd_drawpage = 0;
+	this->SetPixels(0,0, DISPLAY_WIDTH-1,DISPLAY_HEIGHT-1, WHITE);
+	glcd_drawpage = DISPLAY_HEIGHT/8;
+	for(uint8_t chip=0; chip < glcd_CHIP_COUNT; chip++)
+		this->Coord.chip[chip].page = -1;
+	this->Coord.x = -1;	// force a set column on GotoXY
+#endif
+
 	/*
 	 * All hardware initialization is complete.
 	 *
@@ -452,6 +1122,29 @@ int glcd_Device::Init(uint8_t invert)
 	 */
 
 	this->SetPixels(0,0, DISPLAY_WIDTH-1,DISPLAY_HEIGHT-1, WHITE);
+#ifdef GLCD_WRITE_BACK
+	/*
+	 * The glcd memory contents are unknown at this point so the entire
+	 * frame buffer must be sent, not just the bytes that changed.
+	 */
+	for(uint8_t page = 0; page < DISPLAY_HEIGHT/8; page++)
+	{
+		for(uint8_t i = 0; i < sizeof(glcd_dirty[0]); i++)
+			glcd_dirty[page][i] = 0xff;
+	}
+	glcd_dirtycount = glcd_dirtypeak = DISPLAY_WIDTH * (DISPLAY_HEIGHT/8);
+
+#ifdef GLCD_FLUSH_ISR
+	glcd_flushlock = 0;
+#endif
+	/*
+	 * send it all now rather than leave it to the background flush
+	 */
+	this->FlushStep(-1);
+#ifdef GLCD_FLUSH_ISR
+	lcdFlushTimerStart();
+#endif
+#endif
 	this->GotoXY(0,0);
 
 	return(GLCD_ENOERR);
@@ -474,6 +1167,7 @@ __inline__ void glcd_Device::SelectChip(uint8_t chip)
 }
 #endif
 
+#ifndef GLCD_WRITE_ONLY
 // return lcd status bits
 uint8_t glcd_Device::GetStatus(uint8_t chip)
 {
@@ -495,9 +1189,26 @@ uint8_t status;
 }
 
 
+#endif
+
+#ifdef GLCD_WRITE_ONLY
+/*
+ * The busy status can't be read when R/W is tied low,
+ * so wait the longest time the chip can stay busy after an access.
+ */
+void glcd_Device::WaitReady( uint8_t chip)
+{
+	glcd_DevSelectChip(chip);
+	lcdDelayNanoseconds(GLCD_tBUSY);
+}
+#else
 // wait until LCD busy bit goes to zero
 void glcd_Device::WaitReady( uint8_t chip)
 {
+#ifdef GLCD_BUSY_PROFILE
+uint16_t spins = 0;
+
+#endif
 	glcd_DevSelectChip(chip);
 	lcdDataDir(0x00);
 	lcdfastWrite(glcdDI, LOW);	
@@ -506,13 +1217,23 @@ void glcd_Device::WaitReady( uint8_t chip)
 	glcd_DevENstrobeHi(chip);
 	lcdDelayNanoseconds(GLCD_tDDR);
 
+	glcd_StatsInc(chip, polls);
 	while(lcdRdBusystatus())
 	{
-       ;
+		glcd_StatsInc(chip, spins);
+#ifdef GLCD_BUSY_PROFILE
+		if(spins != 0xffff)
+			spins++;
+#endif
 	}
+#ifdef GLCD_BUSY_PROFILE
+	glcd_BusyRecord(chip, spins);
+#endif
 	glcd_DevENstrobeLo(chip);
 }
+#endif
 
+#ifndef GLCD_WRITE_ONLY
 /*
  * read a single data byte from chip
  */
@@ -533,11 +1254,17 @@ uint8_t glcd_Device::DoReadData()
 	data = lcdDataIn();	// Read the data bits from the LCD
 
 	glcd_DevENstrobeLo(chip);
+	glcd_StatsInc(chip, reads);
+	glcd_BusyOp(chip, GLCD_BUSY_READ);
 #ifdef GLCD_XCOL_SUPPORT
-	this->Coord.chip[chip].col++;
+#ifdef GLCD_RMW
+	if(!(glcd_rmwchips & _BV(chip)))	// reads don't move the column in rmw mode
+#endif
+	glcd_ColInc(chip);
 #endif
 	return data;
 }
+#endif
 /**
  * read a data byte from display device memory
  *
@@ -570,7 +1297,7 @@ uint8_t x, data;
 }
 #else
 
-inline uint8_t glcd_Device::ReadData()
+uint8_t glcd_Device::ReadData()
 {  
 uint8_t x, data;
 
@@ -581,7 +1308,28 @@ uint8_t x, data;
 		return(0);
 	}
 
+#ifdef GLCD_RMW
+uint8_t chip = glcd_DevXYval2Chip(x, this->Coord.y);
+
+	/*
+	 * When this read is for the column following the previous read
+	 * the caller is walking through memory doing read-modify-writes,
+	 * so switch the chip into rmw mode. Reads in rmw mode don't advance
+	 * the column so it doesn't have to be set again after the read.
+	 * rmw mode is ended by the next GotoXY() that talks to the chip.
+	 */
+	if(!(glcd_rmwchips & _BV(chip)) && x == (uint8_t)(glcd_rdx+1) && this->Coord.y == glcd_rdy
+		&& glcd_DevXYval2Chip(glcd_rdx, glcd_rdy) == chip)
+	{
+		this->WriteCommand(LCD_RMW, chip);
+		glcd_rmwchips |= _BV(chip);
+	}
+	glcd_rdx = x;
+	glcd_rdy = this->Coord.y;
+#endif
+
 	this->DoReadData();				// dummy read
+	glcd_StatsInc(glcd_DevXYval2Chip(x, this->Coord.y), dummyreads);
 
 	data = this->DoReadData();			// "real" read
 
@@ -590,6 +1338,11 @@ uint8_t x, data;
 		data = ~data;
 	}
 
+#ifdef GLCD_RMW
+	if(glcd_rmwchips & _BV(chip))
+		return(data);
+#endif
+
 	this->Coord.x = -1;	// force a set column on GotoXY
 
 	this->GotoXY(x, this->Coord.y);	
@@ -597,18 +1350,115 @@ uint8_t x, data;
 }
 #endif
 
+/**
+ * read a block of data bytes from display device memory
+ *
+ * @param dst pointer to where to store the data bytes
+ * @param len number of bytes to read
+ *
+ * Reads the bytes of len sequential columns starting at the current x,y position.
+ * Unlike ReadData() which needs a dummy read and a set column for every byte,
+ * there is only a single dummy read for each chip that is read and the
+ * column auto increments between reads.
+ * Bytes beyond the right edge of the display are not read.
+ *
+ * @note the current x,y location is not modified by the routine.
+ *	This allows a read/modify/write operation of a block of bytes.
+ *	Code can call ReadDataBlock() modify the data then
+ *  call WriteDataBlock() and update the same location.
+ *
+ * @see ReadData()
+ * @see WriteDataBlock()
+ */
+
+void glcd_Device::ReadDataBlock(uint8_t *dst, uint8_t len)
+{
+uint8_t x, invert;
+
+	invert = this->Inverted ? 0xff : 0;
+	x = this->Coord.x;
+	if(x >= DISPLAY_WIDTH)
+	{
+		return;
+	}
+
+#ifdef GLCD_READ_CACHE
+	while(len-- && x < DISPLAY_WIDTH)
+	{
+		*dst++ = glcd_rdcache[this->Coord.y/8][x++] ^ invert;
+	}
+#else
+uint8_t n;
+
+	while(len && this->Coord.x < DISPLAY_WIDTH)
+	{
+#ifdef GLCD_RMW
+		/*
+		 * Block reads depend on the column advancing,
+		 * so get the chip out of rmw mode.
+		 */
+		if(glcd_rmwchips & _BV(glcd_DevXYval2Chip(this->Coord.x, this->Coord.y)))
+		{
+			n = this->Coord.x;
+			this->Coord.x = -1;
+			this->GotoXY(n, this->Coord.y);
+		}
+#endif
+
+		/*
+		 * Figure out how many bytes come from this chip
+		 */
+		n = CHIP_WIDTH - this->Coord.x % CHIP_WIDTH;
+		if(n > DISPLAY_WIDTH - this->Coord.x)
+			n = DISPLAY_WIDTH - this->Coord.x;
+		if(n > len)
+			n = len;
+		len -= n;
+
+		this->DoReadData();		// dummy read
+		glcd_StatsInc(glcd_DevXYval2Chip(this->Coord.x, this->Coord.y), dummyreads);
+
+		while(n--)
+		{
+			*dst++ = this->DoReadData() ^ invert;
+			this->Coord.x++;
+		}
+
+		/*
+		 * Position the next chip.
+		 */
+		if(len && this->Coord.x < DISPLAY_WIDTH)
+		{
+			n = this->Coord.x;
+			this->Coord.x = -1;
+			this->GotoXY(n, this->Coord.y);
+		}
+	}
+
+	/*
+	 * The reads have moved the hardware column so put it back
+	 */
+	this->Coord.x = -1;	// force a set column on GotoXY
+	this->GotoXY(x, this->Coord.y);
+#endif
+}
+
 void glcd_Device::WriteCommand(uint8_t cmd, uint8_t chip)
 {
 	this->WaitReady(chip);
 	lcdfastWrite(glcdDI, LOW);					// D/I = 0
+#ifndef GLCD_WRITE_ONLY
 	lcdfastWrite(glcdRW, LOW);					// R/W = 0	
 	lcdDataDir(0xFF);
+#endif
 
 	lcdDataOut(cmd);		/* This could be done before or after raising E */
 	lcdDelayNanoseconds(GLCD_tAS);
 	glcd_DevENstrobeHi(chip);
 	lcdDelayNanoseconds(GLCD_tWH);
 	glcd_DevENstrobeLo(chip);
+	glcd_StatsInc(chip, cmds);
+	glcd_BusyOp(chip, GLCD_BUSY_CMD);
 }
 
 
@@ -657,12 +1507,6 @@ void glcd_Device::WriteData(uint8_t data) {
 	if(yOffset != 0) {
 		// first page
 		displayData = this->ReadData();
-		this->WaitReady(chip);
-   	    lcdfastWrite(glcdDI, HIGH);				// D/I = 1
-	    lcdfastWrite(glcdRW, LOW);				// R/W = 0
-		lcdDataDir(0xFF);						// data port is output
-		lcdDelayNanoseconds(GLCD_tAS);
-		glcd_DevENstrobeHi(chip);
 		
 #ifdef TRUE_WRITE
 		/*
@@ -676,12 +1520,7 @@ void glcd_Device::WriteData(uint8_t data) {
 		if(this->Inverted){
 			displayData = ~displayData;
 		}
-		lcdDataOut( displayData);					// write data
-		lcdDelayNanoseconds(GLCD_tWH);
-		glcd_DevENstrobeLo(chip);
-#ifdef GLCD_READ_CACHE
-		glcd_rdcache[this->Coord.y/8][this->Coord.x] = displayData; // save to read cache
-#endif
+		this->StoreData(displayData, chip);
 
 		// second page
 
@@ -697,15 +1536,9 @@ void glcd_Device::WriteData(uint8_t data) {
 		}
 	
 		this->GotoXY(this->Coord.x, ((ysave+8) & ~7));
+		chip = glcd_DevXYval2Chip(this->Coord.x, this->Coord.y);
 
 		displayData = this->ReadData();
-		this->WaitReady(chip);
-
-   	    lcdfastWrite(glcdDI, HIGH);					// D/I = 1
-	    lcdfastWrite(glcdRW, LOW); 					// R/W = 0	
-		lcdDataDir(0xFF);				// data port is output
-		lcdDelayNanoseconds(GLCD_tAS);
-		glcd_DevENstrobeHi(chip);
 
 #ifdef TRUE_WRITE
 		/*
@@ -718,36 +1551,16 @@ void glcd_Device::WriteData(uint8_t data) {
 		if(this->Inverted){
 			displayData = ~displayData;
 		}
-		lcdDataOut(displayData);		// write data
-		lcdDelayNanoseconds(GLCD_tWH);
-		glcd_DevENstrobeLo(chip);
-#ifdef GLCD_READ_CACHE
-		glcd_rdcache[this->Coord.y/8][this->Coord.x] = displayData; // save to read cache
-#endif
+		this->StoreData(displayData, chip);
+
 		this->GotoXY(this->Coord.x+1, ysave);
 	}else 
 	{
-    	this->WaitReady(chip);
-
-		lcdfastWrite(glcdDI, HIGH);				// D/I = 1
-		lcdfastWrite(glcdRW, LOW);  				// R/W = 0	
-		lcdDataDir(0xFF);						// data port is output
-
 		// just this code gets executed if the write is on a single page
 		if(this->Inverted)
 			data = ~data;	  
 
-		lcdDelayNanoseconds(GLCD_tAS);
-		glcd_DevENstrobeHi(chip);
-	
-		lcdDataOut(data);				// write data
-
-		lcdDelayNanoseconds(GLCD_tWH);
-
-		glcd_DevENstrobeLo(chip);
-#ifdef GLCD_READ_CACHE
-		glcd_rdcache[this->Coord.y/8][this->Coord.x] = data; // save to read cache
-#endif
+		this->StoreData(data, chip);
 
 		/*
 		 * NOTE/WARNING:
@@ -769,9 +1582,6 @@ void glcd_Device::WriteData(uint8_t data) {
 		 */
 
 		this->Coord.x++;
-#ifdef GLCD_XCOL_SUPPORT
-		this->Coord.chip[chip].col++;
-#endif
 
 
 		/*
@@ -790,6 +1600,567 @@ void glcd_Device::WriteData(uint8_t data) {
 	}
 }
 
+/**
+ * Write a block of bytes to display device memory
+ *
+ * @param src pointer to the data bytes in RAM
+ * @param len number of bytes to write
+ * @param color BLACK writes the data as is, WHITE writes the inverse of the data
+ *
+ * The bytes are written to sequential columns starting at the current
+ * x,y position, exactly as if WriteData() was called for each byte.
+ * When y is on a page boundary the bytes are streamed to each chip
+ * using the column auto increment of the glcd, only setting the address
+ * when crossing into the next chip.
+ *
+ * Bytes that would go beyond the right edge of the display are dropped.
+ *
+ * @note the x address will advance by the number of bytes written.
+ *
+ * @see WriteData()
+ * @see WriteDataBlock_P()
+ */
+
+void glcd_Device::WriteDataBlock(const uint8_t *src, uint8_t len, uint8_t color)
+{
+	this->WriteBlock(src, len, color == WHITE ? GLCD_BLK_INVERT : 0);
+}
+
+/**
+ * Write a block of bytes from program memory to display device memory
+ *
+ * @param src pointer to the data bytes in program memory (PROGMEM)
+ * @param len number of bytes to write
+ * @param color BLACK writes the data as is, WHITE writes the inverse of the data
+ *
+ * Same as WriteDataBlock() except the data is read from program memory.
+ *
+ * @see WriteDataBlock()
+ */
+
+void glcd_Device::WriteDataBlock_P(const uint8_t *src, uint8_t len, uint8_t color)
+{
+	this->WriteBlock(src, len, GLCD_BLK_PGM | (color == WHITE ? GLCD_BLK_INVERT : 0));
+}
+
+/*
+ * Write a block of data bytes starting at the current x,y location.
+ */
+void glcd_Device::WriteBlock(const uint8_t *src, uint8_t len, uint8_t flags)
+{
+uint8_t data, chip, n;
+uint8_t invert = (flags & GLCD_BLK_INVERT) ? 0xff : 0;
+
+	if(this->Coord.y & 7)
+	{
+		/*
+		 * Bytes that straddle two pages need a read-modify-write
+		 * of both pages, let WriteData() do it a byte at a time.
+		 */
+		while(len--)
+		{
+			data = (flags & GLCD_BLK_PGM) ? pgm_read_byte(src) : *src;
+			if(!(flags & GLCD_BLK_FILL))
+				src++;
+			this->WriteData(data ^ invert);
+		}
+		return;
+	}
+
+	if(this->Inverted)
+		invert = ~invert;
+
+#ifdef GLCD_BROADCAST
+	/*
+	 * A fill across the entire display writes all the chips at once
+	 */
+	if((flags & GLCD_BLK_FILL) && this->Coord.x == 0 && len >= DISPLAY_WIDTH)
+	{
+		this->FillPage(((flags & GLCD_BLK_PGM) ? pgm_read_byte(src) : *src) ^ invert);
+		return;
+	}
+#endif
+
+	while(len && this->Coord.x < DISPLAY_WIDTH)
+	{
+		/*
+		 * Figure out how many bytes go to this chip
+		 */
+		chip = glcd_DevXYval2Chip(this->Coord.x, this->Coord.y);
+		n = CHIP_WIDTH - this->Coord.x % CHIP_WIDTH;
+		if(n > DISPLAY_WIDTH - this->Coord.x)
+			n = DISPLAY_WIDTH - this->Coord.x;
+		if(n > len)
+			n = len;
+		len -= n;
+
+		while(n--)
+		{
+			data = (flags & GLCD_BLK_PGM) ? pgm_read_byte(src) : *src;
+			if(!(flags & GLCD_BLK_FILL))
+				src++;
+			this->StoreData(data ^ invert, chip);
+			this->Coord.x++;
+		}
+
+		/*
+		 * Reposition the hardware when crossing into the next chip.
+		 */
+		if(this->Coord.x < DISPLAY_WIDTH &&
+			glcd_DevXYval2Chip(this->Coord.x, this->Coord.y) != chip)
+		{
+			uint8_t x = this->Coord.x;
+			this->Coord.x = -1;
+			this->GotoXY(x, this->Coord.y);
+		}
+	}
+}
+
+#ifdef GLCD_BROADCAST
+/*
+ * Fill the page at the current y location across the entire display
+ * with a data byte, writing it to all the chips at once.
+ *
+ * The data is raw glcd memory data, any inversion has already been done.
+ */
+void glcd_Device::FillPage(uint8_t data)
+{
+uint8_t chip, x;
+uint8_t y = this->Coord.y;
+
+	for(chip = 0; chip < glcd_CHIP_COUNT; chip++)
+		this->DoGotoXY(chip * CHIP_WIDTH, y);
+
+	for(x = 0; x < glcd_BCAST_WIDTH; x++)
+	{
+		/*
+		 * Every chip is strobed by the same write, so each one must
+		 * be ready. They were not all positioned at the same time
+		 * so each is waited on in turn.
+		 */
+#ifdef GLCD_WRITE_ONLY
+		lcdDelayNanoseconds(GLCD_tBUSY);
+#else
+		for(chip = 0; chip < glcd_CHIP_COUNT; chip++)
+			this->WaitReady(chip);
+#endif
+		glcd_DevSelectAll();
+		lcdfastWrite(glcdDI, HIGH);				// D/I = 1
+#ifndef GLCD_WRITE_ONLY
+		lcdfastWrite(glcdRW, LOW);  			// R/W = 0	
+		lcdDataDir(0xFF);						// data port is output
+#endif
+
+		lcdDataOut(data);						// write data
+		lcdDelayNanoseconds(GLCD_tAS);
+		glcd_DevENstrobeAllHi();
+		lcdDelayNanoseconds(GLCD_tWH);
+		glcd_DevENstrobeAllLo();
+
+		for(chip = 0; chip < glcd_CHIP_COUNT; chip++)
+		{
+			glcd_StatsInc(chip, writes);
+			glcd_BusyOp(chip, GLCD_BUSY_WRITE);
+#ifdef GLCD_XCOL_SUPPORT
+			glcd_ColInc(chip);
+#endif
+		}
+	}
+
+#if glcd_BCAST_WIDTH < CHIP_WIDTH
+	/*
+	 * The rest of the columns of the chips that are wider than the last one
+	 */
+	for(chip = 0; chip < glcd_CHIP_COUNT-1; chip++)
+	{
+		this->DoGotoXY(chip * CHIP_WIDTH + glcd_BCAST_WIDTH, y);
+		for(x = glcd_BCAST_WIDTH; x < CHIP_WIDTH; x++)
+			this->DoWriteData(data, chip);
+	}
+#endif
+
+#ifdef GLCD_READ_CACHE
+	for(x = 0; x < DISPLAY_WIDTH; x++)
+		glcd_rdcache[y/8][x] = data;
+#endif
+	this->Coord.x = DISPLAY_WIDTH;	// same place a write of the whole page leaves it
+}
+#endif
+
+/*
+ * Store a data byte at the current x,y location.
+ *
+ * The data is raw glcd memory data, any inversion has already been done.
+ * In write back mode the byte only goes into the frame buffer and
+ * the column is marked dirty if the byte changed, otherwise the byte
+ * is written to the glcd.
+ */
+void glcd_Device::StoreData(uint8_t data, uint8_t chip)
+{
+#ifdef GLCD_WRITE_BACK
+uint8_t x = this->Coord.x;
+uint8_t page = this->Coord.y/8;
+
+	(void)chip;
+	if(glcd_rdcache[page][x] == data)
+		return;
+	glcd_rdcache[page][x] = data;
+
+	/*
+	 * The dirty bit is set after the frame buffer is updated. If the
+	 * background flush sends the byte in between, it is just sent again.
+	 */
+	glcd_FlushAtomic()
+	{
+		if(!glcd_IsDirty(page, x))
+		{
+			glcd_dirty[page][x/8] |= _BV(x%8);
+			if(++glcd_dirtycount > glcd_dirtypeak)
+				glcd_dirtypeak = glcd_dirtycount;
+		}
+	}
+#else
+	this->DoWriteData(data, chip);
+#ifdef GLCD_READ_CACHE
+	glcd_rdcache[this->Coord.y/8][this->Coord.x] = data; // save to read cache
+#endif
+#endif
+}
+
+/*
+ * write a single data byte to the current glcd hardware location
+ */
+void glcd_Device::DoWriteData(uint8_t data, uint8_t chip)
+{
+	this->WaitReady(chip);
+
+	lcdfastWrite(glcdDI, HIGH);				// D/I = 1
+#ifndef GLCD_WRITE_ONLY
+	lcdfastWrite(glcdRW, LOW);  			// R/W = 0	
+	lcdDataDir(0xFF);						// data port is output
+#endif
+
+	lcdDataOut(data);						// write data
+	lcdDelayNanoseconds(GLCD_tAS);
+	glcd_DevENstrobeHi(chip);
+	lcdDelayNanoseconds(GLCD_tWH);
+	glcd_DevENstrobeLo(chip);
+	glcd_StatsInc(chip, writes);
+	glcd_BusyOp(chip, GLCD_BUSY_WRITE);
+#ifdef GLCD_XCOL_SUPPORT
+	glcd_ColInc(chip);
+#endif
+}
+
+/**
+ * Send frame buffer updates to the display
+ *
+ * When write back mode is enabled (GLCD_WRITE_BACK in glcd_Config.h)
+ * the drawing functions only update the frame buffer in RAM.
+ * Flush() sends the bytes that have changed since the last Flush()
+ * to the glcd.
+ * Call it when a screen update is complete.
+ *
+ * When the background flush is enabled (GLCD_FLUSH_ISR in glcd_Config.h)
+ * changes are sent by a timer interrupt and this function does nothing.
+ * Use WaitFlush() to wait for the display to be up to date.
+ *
+ * When write back mode is not enabled all drawing goes directly to the
+ * display and this function does nothing.
+ *
+ * @see FlushStep()
+ * @see WaitFlush()
+ */
+
+void glcd_Device::Flush(void)
+{
+#if defined(GLCD_WRITE_BACK) && !defined(GLCD_FLUSH_ISR)
+	this->FlushStep(-1);
+#endif
+}
+
+/**
+ * Send some of the frame buffer updates to the display
+ *
+ * @param count the most bytes to send
+ *
+ * Sends up to count of the bytes that have changed since they were
+ * last sent. The next call continues where this one left off.
+ * This allows spreading a Flush() out over time,
+ * for example a few bytes each time through loop().
+ *
+ * @returns the number of changed bytes still waiting to be sent
+ *
+ * @note It is safe to call this with the background flush enabled
+ * but there is no need to.
+ *
+ * @see Flush()
+ */
+
+uint16_t glcd_Device::FlushStep(uint16_t count)
+{
+#ifdef GLCD_WRITE_BACK
+uint8_t page, lane, col, width, x, gap, chip;
+uint8_t run = 0;	// lanes whose chip is positioned at the lane's next column
+uint8_t idle = 0;	// lanes in a row found at the end of the page
+
+#ifdef GLCD_FLUSH_ISR
+	if(glcd_flushlock)
+		return(glcd_dirtycount); // the hardware is in use (only seen by the interrupt)
+	glcd_flushlock = 1;
+#endif
+
+	page = glcd_flushpage;
+	lane = glcd_flushlane;
+
+	while(count && glcd_dirtycount)
+	{
+		col = glcd_flushcol[lane];
+		width = glcd_LaneWidth(lane);
+		x = lane * CHIP_WIDTH + col;
+
+		if(col >= width)
+		{
+			/*
+			 * Move on to the next page once every lane is through this one
+			 */
+			if(++idle >= glcd_FLUSH_LANES)
+			{
+				for(lane = 0; lane < glcd_FLUSH_LANES; lane++)
+					glcd_flushcol[lane] = 0;
+				lane = 0;
+				idle = 0;
+				run = 0;
+				if(++page >= DISPLAY_HEIGHT/8)
+					page = 0;
+				continue;
+			}
+			if(++lane >= glcd_FLUSH_LANES)
+				lane = 0;
+			continue;
+		}
+		idle = 0;
+
+		if(!(run & _BV(lane)))
+		{
+			/*
+			 * find the start of the next dirty run
+			 * skipping clean groups of 8 columns at a time.
+			 */
+			if(!glcd_dirty[page][x/8])
+			{
+				col += 8 - x % 8;
+				glcd_flushcol[lane] = col < width ? col : width;
+				continue;
+			}
+			if(!glcd_IsDirty(page, x))
+			{
+				glcd_flushcol[lane] = col + 1;
+				continue;
+			}
+
+			/*
+			 * Position the hardware once for the run, the column
+			 * auto increments for the rest of it.
+			 * Note: a page address is only sent when the chip's page changes.
+			 */
+			this->DoGotoXY(x, page*8);
+			run |= _BV(lane);
+		}
+
+		/*
+		 * The dirty bit is cleared before the byte is read from the
+		 * frame buffer so a change made after this is not lost.
+		 */
+		glcd_FlushAtomic()
+		{
+			if(glcd_IsDirty(page, x))
+			{
+				glcd_dirty[page][x/8] &= ~_BV(x%8);
+				glcd_dirtycount--;
+			}
+		}
+		chip = glcd_DevXYval2Chip(x, page*8);
+		this->DoWriteData(glcd_rdcache[page][x], chip);
+		col++;
+		x++;
+		count--;
+
+		/*
+		 * Look ahead for the next dirty column in this lane, merging in
+		 * any gap of clean columns that is cheaper to rewrite than to
+		 * re-address around. A run always ends at the end of the lane.
+		 */
+		for(gap = 0; gap <= GLCD_FLUSH_GAP; gap++)
+		{
+			if(col+gap >= width)
+			{
+				gap = GLCD_FLUSH_GAP+1;
+				break;
+			}
+			if(glcd_IsDirty(page, x+gap))
+				break;
+		}
+		if(gap > GLCD_FLUSH_GAP)
+			run &= ~_BV(lane);	// end of run
+		glcd_flushcol[lane] = col;
+
+		if(++lane >= glcd_FLUSH_LANES)
+			lane = 0;
+	}
+
+	glcd_flushpage = page;
+	glcd_flushlane = lane;
+
+#ifdef GLCD_FLUSH_ISR
+	glcd_flushlock = 0;
+#endif
+	return(glcd_dirtycount);
+#else
+	(void)count;
+	return(0);
+#endif
+}
+
+/**
+ * Wait for the display to be up to date
+ *
+ * With the background flush (GLCD_FLUSH_ISR) this waits until the timer
+ * interrupt has sent all the changes in the frame buffer.
+ * Otherwise it is the same as Flush().
+ *
+ * @see Flush()
+ */
+
+void glcd_Device::WaitFlush(void)
+{
+#ifdef GLCD_FLUSH_ISR
+	while(this->FlushPending())
+		;
+#else
+	this->Flush();
+#endif
+}
+
+/**
+ * Get the number of changed bytes waiting to be sent
+ *
+ * @returns the number of bytes in the frame buffer that have changed
+ * but have not yet been sent to the display.
+ * It is always 0 when write back mode is not enabled.
+ *
+ * @see FlushPeak()
+ */
+
+uint16_t glcd_Device::FlushPending(void)
+{
+#ifdef GLCD_WRITE_BACK
+uint16_t count;
+
+	glcd_FlushAtomic()
+	{
+		count = glcd_dirtycount;
+	}
+	return(count);
+#else
+	return(0);
+#endif
+}
+
+/**
+ * Get the most changed bytes that have been waiting to be sent
+ *
+ * @returns the largest number of bytes that were waiting to be sent
+ * since the previous call.
+ *
+ * This shows how far the display has fallen behind the drawing,
+ * for example to tune GLCD_FLUSH_ISR_BYTES.
+ *
+ * @see FlushPending()
+ */
+
+uint16_t glcd_Device::FlushPeak(void)
+{
+#ifdef GLCD_WRITE_BACK
+uint16_t count;
+
+	glcd_FlushAtomic()
+	{
+		count = glcd_dirtypeak;
+		glcd_dirtypeak = glcd_dirtycount;
+	}
+	return(count);
+#else
+	return(0);
+#endif
+}
+
+#ifdef GLCD_STATS
+/**
+ * Start counting glcd bus transactions
+ *
+ * @param stats where to keep the counts
+ *
+ * Only available when GLCD_STATS is defined in glcd_Config.h.
+ *
+ * StatsBegin() takes a snapshot of the running counts and StatsEnd()
+ * turns it into the counts of what was sent to each glcd chip in between.
+ * Since the running counts are never reset, StatsBegin()/StatsEnd()
+ * pairs can be nested to measure parts of a larger operation.
+ *
+ * With the background flush (GLCD_FLUSH_ISR) the counts include
+ * whatever the timer interrupt sent in between.
+ *
+ * Example:
+ * @code
+ * glcdStats_t stats;
+ *
+ * GLCD.StatsBegin(&stats);
+ * GLCD.DrawCircle(32, 32, 20);
+ * GLCD.StatsEnd(&stats);
+ * Serial.println(stats.chip[0].cmds);
+ * @endcode
+ *
+ * @see StatsEnd()
+ */
+
+void glcd_Device::StatsBegin(glcdStats_t *stats)
+{
+#ifdef GLCD_FLUSH_ISR
+	glcd_FlushAtomic()
+#endif
+	{
+		*stats = glcd_stats;
+	}
+}
+
+/**
+ * Stop counting glcd bus transactions
+ *
+ * @param stats the counts started by StatsBegin()
+ *
+ * On return @em stats holds the bus transactions of each chip
+ * since the matching StatsBegin().
+ *
+ * @see StatsBegin()
+ */
+
+void glcd_Device::StatsEnd(glcdStats_t *stats)
+{
+unsigned long *count = (unsigned long *) stats;
+unsigned long *now = (unsigned long *) &glcd_stats;
+uint8_t i;
+
+#ifdef GLCD_FLUSH_ISR
+	glcd_FlushAtomic()
+#endif
+	{
+		for(i = 0; i < sizeof(glcdStats_t)/sizeof(unsigned long); i++)
+			count[i] = now[i] - count[i];
+	}
+}
+#endif
+
 /*
  * needed to resolve virtual print functions
  */
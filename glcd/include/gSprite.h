@@ -0,0 +1,149 @@
+/*
+  gSprite.h - Support for sprites moving over a background on a graphical device
+  Copyright (c) 2026  GLCD library contributors
+
+  vi:ts=4
+
+  This file is part of the Arduino GLCD library.
+
+  GLCD is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 2.1 of the License, or
+  (at your option) any later version.
+
+  GLCD is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with GLCD.  If not, see <http://www.gnu.org/licenses/>.
+
+  This file is included by glcd.h, which defines Image_t.
+
+*/
+
+#ifndef	GSPRITE_H
+#define GSPRITE_H
+
+#include <inttypes.h>
+#include <avr/pgmspace.h>
+
+#include "include/glcd_Device.h"
+
+#define GSPRITE_VERSION 1 // software version of this code
+
+/*
+ * Most separate areas of the display an Update() collects before it
+ * starts merging them. Each one costs 4 bytes of stack.
+ */
+#ifndef GLCD_SPRITE_RECTS
+#define GLCD_SPRITE_RECTS	4
+#endif
+
+/// @cond hide_from_doxygen
+/*
+ * Area of the display, as columns and memory pages, inclusive
+ */
+typedef struct
+{
+	uint8_t x1, x2;
+	uint8_t p1, p2;
+} spriteRect_t;
+
+/*
+ * Sprite flags
+ */
+#define GSPRITE_SHOWN	1	// drawn when its area is updated
+#define GSPRITE_DIRTY	2	// changed since its area was last updated
+#define GSPRITE_DRAWN	4	// Drawn holds where it is on the display
+/// @endcond
+
+class gSpriteArea;
+
+/**
+ * @class gSprite
+ * @brief A bitmap that moves over the background of a sprite area
+ * @details
+ * A sprite is a glcd bitmap in program memory with an optional mask.
+ * Where the mask has a pixel set the sprite covers whatever is under it
+ * with its own pixel, elsewhere it is transparent. Without a mask only the
+ * pixels set in the bitmap are drawn.
+ *
+ * Changing a sprite doesn't draw anything, the display is brought up to date by
+ * gSpriteArea::Update() after the sprites of the area have been changed.
+ */
+class gSprite
+{
+	friend class gSpriteArea;
+
+  private:
+	Image_t			Image;
+	Image_t			Mask;
+	uint8_t			X;
+	uint8_t			Y;
+	uint8_t			Z;
+	uint8_t			Flags;
+	spriteRect_t	Drawn;	// area of the display it was last drawn in
+	gSprite			*Next;	// next sprite of the area, in z order
+	gSpriteArea		*Area;
+	unpackState_t	Unpack[4];	// decoders of a compressed image and mask, used while it is drawn
+
+  public:
+	gSprite();
+	gSprite(Image_t image, Image_t mask=0, uint8_t z=0);
+
+/** @name SPRITE FUNCTIONS
+ * The following sprite functions are available
+ */
+/*@{*/
+	void SetImage(Image_t image, Image_t mask=0);
+	void MoveTo(uint8_t x, uint8_t y);
+	void SetZ(uint8_t z);
+	void Show(void);
+	void Hide(void);
+/*@}*/
+};
+
+/**
+ * @class gSpriteArea
+ * @brief An area of the display where sprites move over a background
+ * @details
+ * The area owns its pixels: they are the background with the shown
+ * sprites drawn over it in z order. When sprites change, Update() rewrites
+ * only the parts of the area the sprites were in and are now in, each
+ * byte of the display once and without reading it back.
+ */
+class gSpriteArea : public glcd_Device
+{
+	friend class gSprite;
+
+  private:
+	lcdClip			Bounds;
+	gSprite			*Sprites;	// sprites of the area, lowest z first
+	Image_t			Background;
+	uint8_t			BgColor;
+
+	void Link(gSprite *sprite);
+	void Unlink(gSprite *sprite);
+	uint8_t SpriteRect(gSprite *sprite, spriteRect_t *rect);
+	void Compose(spriteRect_t *rect);
+
+  public:
+	gSpriteArea(); // default - uses the entire display
+	gSpriteArea(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2);
+
+/** @name SPRITE AREA FUNCTIONS
+ * The following sprite area functions are available
+ */
+/*@{*/
+	void DefineArea(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2);
+	void SetBackground(Image_t bitmap, uint8_t color=WHITE);
+	void Add(gSprite &sprite);
+	void Remove(gSprite &sprite);
+	void Update(void);
+	void Redraw(void);
+/*@}*/
+};
+
+#endif
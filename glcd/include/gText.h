@@ -96,6 +96,31 @@ const textMode SCROLL_UP = 0;
 const textMode SCROLL_DOWN = 1; // this was changed from -1 so it can used in a bitmask 
 const textMode DEFAULT_SCROLLDIR = SCROLL_UP;
 
+/// @cond hide_from_doxygen
+/*
+ * State of a scroll so that it can be done a page at a time
+ */
+typedef struct
+{
+	uint8_t x2, y1, y2;
+	uint8_t pixels, color;
+	textMode dir;
+	uint8_t col, n;		// block of columns being scrolled
+	uint8_t page;		// next destination page
+	int8_t spage;		// source page held in buf[cur]
+	uint8_t cur;
+	uint8_t buf[2][GLCD_BLKSIZE];
+} scrollState_t;
+
+/*
+ * Operations that Step() can do a piece at a time
+ */
+#define GLCD_STEP_FILL		1
+#define GLCD_STEP_BITMAP	2
+#define GLCD_STEP_STRING	3
+#define GLCD_STEP_STRING_P	4
+/// @endcond
+
 /**
  * @defgroup glcd_enum GLCD enumerations
  */
@@ -168,7 +193,7 @@ typedef const uint8_t* Font_t;
 typedef uint8_t (*FontCallback)(Font_t);
 
 uint8_t ReadPgmData(const uint8_t* ptr);	//Standard Read Callback
-static FontCallback	FontRead;               // font callback shared across all instances
+static FontCallback	FontRead __attribute__((unused));	// font callback shared across all instances (only gText.cpp uses it)
 //static glcd_Device    *device;              // static pointer to the device instance
 
 /// @cond hide_from_doxygen
@@ -197,6 +222,7 @@ class gText : public glcd_Device
   private:
     //FontCallback	FontRead;     // now static, move back here if each instance needs its own callback
 	uint8_t			FontColor;
+	uint8_t			FontRop;
 	Font_t			Font;
 	struct tarea tarea;
 	uint8_t			x;
@@ -210,6 +236,16 @@ class gText : public glcd_Device
 	// Scroll routines are private for now
 	void ScrollUp(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, uint8_t pixels, uint8_t color);
 	void ScrollDown(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, uint8_t pixels, uint8_t color);
+	void ScrollStart(scrollState_t *scroll, uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2,
+		uint8_t pixels, uint8_t color, textMode dir);
+	uint8_t ScrollPage(scrollState_t *scroll);
+
+	void WrapChar(uint8_t width);
+	void StepWrap(uint8_t c);
+
+  protected:
+	void StepStart(uint8_t op, uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2,
+		uint8_t color, const void *data, uint8_t bx=0, uint8_t by=0);
 
   public:
 	gText(); // default - uses the entire display
@@ -235,6 +271,7 @@ class gText : public glcd_Device
 	// Font Functions
 	void SelectFont(Font_t font, uint8_t color=BLACK, FontCallback callback=ReadPgmData); // default arguments added, callback now last arg
 	void SetFontColor(uint8_t color); // new method
+	void SetFontRop(uint8_t rop);
 	int PutChar(uint8_t c);
 	void Puts(char *str);
 	void Puts(const String &str); // for Arduino String Class
@@ -242,6 +279,9 @@ class gText : public glcd_Device
 	void DrawString(char *str, uint8_t x, uint8_t y);
 	void DrawString(String &str, uint8_t x, uint8_t y); // for Arduino String class
 	void DrawString_P(PGM_P str, uint8_t x, uint8_t y);
+	void StepDrawString(const char *str, uint8_t x, uint8_t y);
+	void StepDrawString_P(PGM_P str, uint8_t x, uint8_t y);
+	uint8_t Step(uint16_t us);
 
 #if ARDUINO < 100
 	void write(uint8_t c);  // character output for print base class
@@ -38,6 +38,79 @@
 
 #define GLCD_Device 1 // software version of this class
 
+/*
+ * the background flush sends the frame buffer of write back mode
+ */
+#if defined(GLCD_FLUSH_ISR) && !defined(GLCD_WRITE_BACK)
+#define GLCD_WRITE_BACK
+#endif
+
+#if defined(GLCD_FLUSH_ISR) && !defined(GLCD_FLUSH_ISR_BYTES)
+#define GLCD_FLUSH_ISR_BYTES 16		// most bytes sent per timer interrupt
+#endif
+
+/*
+ * write back mode is built on top of the read cache frame buffer
+ */
+#if defined(GLCD_WRITE_BACK) && !defined(GLCD_READ_CACHE)
+#define GLCD_READ_CACHE
+#endif
+
+/*
+ * write only mode can't read the glcd so all reads must come from the frame buffer
+ */
+#if defined(GLCD_WRITE_ONLY) && !defined(GLCD_READ_CACHE)
+#define GLCD_READ_CACHE
+#endif
+
+/*
+ * the busy profile is part of the bus transaction counts
+ */
+#if defined(GLCD_BUSY_PROFILE) && !defined(GLCD_STATS)
+#define GLCD_STATS
+#endif
+
+/*
+ * track the hardware column of each chip to minimize set column commands
+ */
+#if !defined(GLCD_NOXCOL_SUPPORT) && !defined(GLCD_XCOL_SUPPORT)
+#define GLCD_XCOL_SUPPORT
+#endif
+
+/*
+ * scroll full display text areas by moving the display start line.
+ * This needs each chip to cover the full height of the display
+ * and the start line to wrap around exactly the display lines.
+ */
+#if defined(glcd_DevStartLine) && (CHIP_HEIGHT == DISPLAY_HEIGHT) && (CHIP_HEIGHT == glcd_DevLines) \
+	&& !defined(GLCD_NO_HWSCROLL)
+#define GLCD_HWSCROLL
+#endif
+
+/*
+ * double buffering draws into a second frame in the glcd memory
+ * and shows it by moving the display start line.
+ * The memory of each chip has to hold two frames.
+ */
+#ifdef GLCD_DOUBLE_BUFFER
+#if !defined(glcd_DevStartLine) || (CHIP_HEIGHT != DISPLAY_HEIGHT) || (glcd_DevLines < 2 * DISPLAY_HEIGHT)
+#error "GLCD_DOUBLE_BUFFER needs a device with glcd memory for two frames"
+#endif
+#ifdef GLCD_READ_CACHE
+#error "GLCD_DOUBLE_BUFFER can't be used with GLCD_READ_CACHE, GLCD_WRITE_BACK or GLCD_WRITE_ONLY"
+#endif
+#endif
+
+/*
+ * Fills of whole pages write all the chips at once when the device
+ * can strobe all the chips together and the chips are side by side.
+ * In write back mode drawing doesn't write the glcd so it doesn't apply.
+ */
+#if defined(glcd_DevENstrobeAllHi) && (glcd_CHIP_COUNT > 1) && (CHIP_HEIGHT == DISPLAY_HEIGHT) \
+	&& !defined(GLCD_WRITE_BACK)
+#define GLCD_BROADCAST
+#endif
+
 
 // useful user constants
 #define NON_INVERTED false
@@ -47,6 +120,27 @@
 #define BLACK				0xFF
 #define WHITE				0x00
 
+// Raster operations, how the pixels drawn combine with those on the display
+#define GLCD_ROP_COPY		0	// replace the display pixels
+#define GLCD_ROP_OR			1	// set where the pixels drawn are set
+#define GLCD_ROP_AND		2	// clear where the pixels drawn are clear
+#define GLCD_ROP_XOR		3	// invert where the pixels drawn are set
+#define GLCD_ROP_ANDNOT		4	// clear where the pixels drawn are set
+
+/*
+ * A compressed bitmap starts with a 0 where the width would be,
+ * followed by the format of the data, then the width and height.
+ */
+#define GLCD_BITMAP_PACKBITS	1	// PackBits run length encoded
+
+/*
+ * Size of the buffers used for block read-modify-write operations.
+ * Each buffer costs this many bytes of stack.
+ */
+#ifndef GLCD_BLKSIZE
+#define GLCD_BLKSIZE		16
+#endif
+
 /// @cond hide_from_doxygen
 typedef struct {
 	uint8_t x;
@@ -58,7 +152,75 @@ typedef struct {
 		uint8_t page;
 	} chip[glcd_CHIP_COUNT];
 } lcdCoord;
+
+/*
+ * Area of the display that drawing is confined to, inclusive
+ */
+typedef struct {
+	uint8_t x1;
+	uint8_t y1;
+	uint8_t x2;
+	uint8_t y2;
+} lcdClip;
+
+/*
+ * Decoder of the data of a PackBits compressed bitmap, see glcd_UnpackStart()
+ */
+typedef struct {
+	const uint8_t *src;	// next byte of compressed data
+	uint16_t pos;		// offset in the bitmap data of the next byte decoded
+	uint8_t count;		// bytes left in the current run
+	uint8_t repeat;		// the current run repeats data, else it is literal bytes from src
+	uint8_t data;
+} unpackState_t;
+
+void glcd_UnpackStart(unpackState_t *unpack, const uint8_t *data);
+uint8_t glcd_UnpackByte(unpackState_t *unpack);
+void glcd_UnpackSeek(unpackState_t *unpack, uint16_t pos);
 /// @endcond
+
+#ifdef GLCD_STATS
+#ifdef GLCD_BUSY_PROFILE
+/*
+ * Kinds of access a chip can be busy after
+ */
+#define GLCD_BUSY_CMD		0	// command write
+#define GLCD_BUSY_WRITE		1	// data write
+#define GLCD_BUSY_READ		2	// data read
+#define GLCD_BUSY_OPS		3
+
+/*
+ * Histogram bucket n counts busy waits of 2^(n-1) to 2^n-1 passes of the
+ * wait loop, bucket 0 counts accesses that found the chip not busy
+ * and the last bucket also counts anything longer.
+ */
+#define GLCD_BUSY_BUCKETS	8
+#endif
+
+/**
+ * Bus transaction counts of one glcd chip
+ */
+typedef struct {
+	unsigned long cmds;			/**< command writes */
+	unsigned long writes;		/**< data writes */
+	unsigned long reads;		/**< data reads, including dummy reads */
+	unsigned long dummyreads;	/**< dummy reads */
+	unsigned long polls;		/**< status reads to wait for not busy */
+	unsigned long spins;		/**< passes of the wait loop that saw busy */
+	unsigned long gotoxy;		/**< GotoXY() calls that moved to this chip */
+#ifdef GLCD_BUSY_PROFILE
+	/** busy wait histogram for each kind of access the chip was busy after */
+	unsigned long busy[GLCD_BUSY_OPS][GLCD_BUSY_BUCKETS];
+#endif
+} glcdChipStats_t;
+
+/**
+ * Bus transaction counts, see StatsBegin()
+ */
+typedef struct {
+	glcdChipStats_t chip[glcd_CHIP_COUNT];
+} glcdStats_t;
+#endif
 	
 /*
  * Note that all data in glcd_Device is static so that all derived instances  
@@ -77,7 +239,17 @@ class glcd_Device : public Print
   private:
   // Control functions
 	uint8_t DoReadData(void);
+	void DoWriteData(uint8_t data, uint8_t chip);
+	void StoreData(uint8_t data, uint8_t chip);
+	void DoGotoXY(uint8_t x, uint8_t y);
+	void WriteBlock(const uint8_t *src, uint8_t len, uint8_t flags);
+#ifdef GLCD_BROADCAST
+	void FillPage(uint8_t data);
+#endif
 	void WriteCommand(uint8_t cmd, uint8_t chip);
+#if defined(GLCD_HWSCROLL) || defined(GLCD_DOUBLE_BUFFER)
+	void SetStartLine(uint8_t line);
+#endif
 	inline void Enable(void);
 	inline void SelectChip(uint8_t chip); 
 	void WaitReady(uint8_t chip);
@@ -94,12 +266,57 @@ class glcd_Device : public Print
     int Init(uint8_t invert = false);      // now public, default is non-inverted
 	void SetDot(uint8_t x, uint8_t y, uint8_t color);
 	void SetPixels(uint8_t x, uint8_t y,uint8_t x1, uint8_t y1, uint8_t color);
+	void SetClipArea(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2);
+	void ResetClipArea(void);
     uint8_t ReadData(void);        // now public
     void WriteData(uint8_t data); 
+	void WriteDataBlock(const uint8_t *src, uint8_t len, uint8_t color=BLACK);
+	void WriteDataBlock_P(const uint8_t *src, uint8_t len, uint8_t color=BLACK);
+	void ReadDataBlock(uint8_t *dst, uint8_t len);
+	void ModifyData(uint8_t x, uint8_t y, uint8_t width, uint8_t andbits, uint8_t orbits, uint8_t xorbits);
+	void ModifyArea(uint8_t x, uint8_t y, uint8_t x2, uint8_t y2, uint8_t andbits, uint8_t orbits, uint8_t xorbits);
+	void BitmapArea(const uint8_t *bitmap, uint8_t x, uint8_t y,
+		uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, uint8_t color, uint8_t rop);
+	static inline uint8_t RopData(uint8_t rop, uint8_t src, uint8_t data);
+#ifdef GLCD_HWSCROLL
+	void ScrollPages(int8_t pages);
+#endif
+#ifdef GLCD_DOUBLE_BUFFER
+	void SwapBuffers(void);
+#endif
+	void Flush(void);
+	uint16_t FlushStep(uint16_t count);
+	void WaitFlush(void);
+	uint16_t FlushPending(void);
+	uint16_t FlushPeak(void);
+#ifdef GLCD_STATS
+	void StatsBegin(glcdStats_t *stats);
+	void StatsEnd(glcdStats_t *stats);
+#endif
 
   	void GotoXY(uint8_t x, uint8_t y);   
     static lcdCoord	  	Coord;  
+	static lcdClip		Clip;
 	static uint8_t	 	Inverted; 
 };
+
+/*
+ * Combine a byte of pixels drawn with a byte of display data using raster op rop
+ */
+inline uint8_t glcd_Device::RopData(uint8_t rop, uint8_t src, uint8_t data)
+{
+	switch(rop)
+	{
+	  case GLCD_ROP_OR:
+		return(data | src);
+	  case GLCD_ROP_AND:
+		return(data & src);
+	  case GLCD_ROP_XOR:
+		return(data ^ src);
+	  case GLCD_ROP_ANDNOT:
+		return(data & ~src);
+	}
+	return(src);
+}
   
 #endif
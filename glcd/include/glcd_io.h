@@ -28,6 +28,10 @@
 #ifndef	GLCD_IO_H
 #define GLCD_IO_H
 
+#ifdef GLCD_HOST
+#include "include/hostio.h"        // emulated bus for host (PC) builds
+#else
+
 #if ARDUINO < 100
 #include "wiring.h"
 #else
@@ -141,6 +145,15 @@
 #define lcdUnReset()		
 #endif
 
+/*
+ * Timer interrupt for the background flush (GLCD_FLUSH_ISR).
+ * It shares timer0 with the Arduino core millis() code by using
+ * the timer0 compare B interrupt. It occurs once per timer0 overflow
+ * period (~1ms) no matter what the compare value is.
+ */
+#define lcdFlushTimerVect		TIMER0_COMPB_vect
+#define lcdFlushTimerStart()	(TIMSK0 |= _BV(OCIE0B))
+
 #endif // _AVRIO_AVRIO_
 
 /*
@@ -167,6 +180,8 @@
 
 #define lcdDelayMilliseconds(__ms) delay(__ms)	// Arduino delay function
 
+#endif // GLCD_HOST
+
 
 /*
  * functions to perform chip selects on panel configurations
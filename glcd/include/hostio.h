@@ -0,0 +1,179 @@
+/*
+  hostio.h - emulated bus i/o primitives for host (PC) builds
+  Copyright (c) 2010 Bill Perry
+  
+  vi:ts=4
+
+  This file is part of the Arduino GLCD library.
+
+  GLCD is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 2.1 of the License, or
+  (at your option) any later version.
+
+  GLCD is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with GLCD.  If not, see <http://www.gnu.org/licenses/>.
+
+  This file maps the abstract io requests from glcd_Device onto the
+  software controller model in debug/host/glcd_Emulator.cpp.
+  It takes the place of arduino_io.h and avrio.h when GLCD_HOST is defined
+  so the library can be built and run on a PC without any hardware.
+ 
+ */
+
+#ifndef	GLCD_HOSTIO_H
+#define GLCD_HOSTIO_H
+
+#include "Arduino.h"
+#include "glcd_Emulator.h"
+
+#ifndef OUTPUT
+#define OUTPUT 1
+#endif
+
+#ifndef LOW
+#define LOW 0
+#endif
+
+#ifndef HIGH
+#define HIGH 1
+#endif
+
+/*
+ * avrio style PIN_Pb pin names so that configuration files using them
+ * can be used on the host. They use the same encoding as avrio.
+ */
+#define GLCD_HOSTPIN(port, bit)	(((port) << 4) | (bit))
+
+#define PIN_A0	GLCD_HOSTPIN(0xa, 0)
+#define PIN_A1	GLCD_HOSTPIN(0xa, 1)
+#define PIN_A2	GLCD_HOSTPIN(0xa, 2)
+#define PIN_A3	GLCD_HOSTPIN(0xa, 3)
+#define PIN_A4	GLCD_HOSTPIN(0xa, 4)
+#define PIN_A5	GLCD_HOSTPIN(0xa, 5)
+#define PIN_A6	GLCD_HOSTPIN(0xa, 6)
+#define PIN_A7	GLCD_HOSTPIN(0xa, 7)
+#define PIN_B0	GLCD_HOSTPIN(0xb, 0)
+#define PIN_B1	GLCD_HOSTPIN(0xb, 1)
+#define PIN_B2	GLCD_HOSTPIN(0xb, 2)
+#define PIN_B3	GLCD_HOSTPIN(0xb, 3)
+#define PIN_B4	GLCD_HOSTPIN(0xb, 4)
+#define PIN_B5	GLCD_HOSTPIN(0xb, 5)
+#define PIN_B6	GLCD_HOSTPIN(0xb, 6)
+#define PIN_B7	GLCD_HOSTPIN(0xb, 7)
+#define PIN_C0	GLCD_HOSTPIN(0xc, 0)
+#define PIN_C1	GLCD_HOSTPIN(0xc, 1)
+#define PIN_C2	GLCD_HOSTPIN(0xc, 2)
+#define PIN_C3	GLCD_HOSTPIN(0xc, 3)
+#define PIN_C4	GLCD_HOSTPIN(0xc, 4)
+#define PIN_C5	GLCD_HOSTPIN(0xc, 5)
+#define PIN_C6	GLCD_HOSTPIN(0xc, 6)
+#define PIN_C7	GLCD_HOSTPIN(0xc, 7)
+#define PIN_D0	GLCD_HOSTPIN(0xd, 0)
+#define PIN_D1	GLCD_HOSTPIN(0xd, 1)
+#define PIN_D2	GLCD_HOSTPIN(0xd, 2)
+#define PIN_D3	GLCD_HOSTPIN(0xd, 3)
+#define PIN_D4	GLCD_HOSTPIN(0xd, 4)
+#define PIN_D5	GLCD_HOSTPIN(0xd, 5)
+#define PIN_D6	GLCD_HOSTPIN(0xd, 6)
+#define PIN_D7	GLCD_HOSTPIN(0xd, 7)
+#define PIN_E0	GLCD_HOSTPIN(0xe, 0)
+#define PIN_E1	GLCD_HOSTPIN(0xe, 1)
+#define PIN_E2	GLCD_HOSTPIN(0xe, 2)
+#define PIN_E3	GLCD_HOSTPIN(0xe, 3)
+#define PIN_E4	GLCD_HOSTPIN(0xe, 4)
+#define PIN_E5	GLCD_HOSTPIN(0xe, 5)
+#define PIN_E6	GLCD_HOSTPIN(0xe, 6)
+#define PIN_E7	GLCD_HOSTPIN(0xe, 7)
+#define PIN_F0	GLCD_HOSTPIN(0xf, 0)
+#define PIN_F1	GLCD_HOSTPIN(0xf, 1)
+#define PIN_F2	GLCD_HOSTPIN(0xf, 2)
+#define PIN_F3	GLCD_HOSTPIN(0xf, 3)
+#define PIN_F4	GLCD_HOSTPIN(0xf, 4)
+#define PIN_F5	GLCD_HOSTPIN(0xf, 5)
+#define PIN_F6	GLCD_HOSTPIN(0xf, 6)
+#define PIN_F7	GLCD_HOSTPIN(0xf, 7)
+#define PIN_G0	GLCD_HOSTPIN(0x10, 0)
+#define PIN_G1	GLCD_HOSTPIN(0x10, 1)
+#define PIN_G2	GLCD_HOSTPIN(0x10, 2)
+#define PIN_G3	GLCD_HOSTPIN(0x10, 3)
+#define PIN_G4	GLCD_HOSTPIN(0x10, 4)
+#define PIN_G5	GLCD_HOSTPIN(0x10, 5)
+#define PIN_G6	GLCD_HOSTPIN(0x10, 6)
+#define PIN_G7	GLCD_HOSTPIN(0x10, 7)
+#define PIN_H0	GLCD_HOSTPIN(0x11, 0)
+#define PIN_H1	GLCD_HOSTPIN(0x11, 1)
+#define PIN_H2	GLCD_HOSTPIN(0x11, 2)
+#define PIN_H3	GLCD_HOSTPIN(0x11, 3)
+#define PIN_H4	GLCD_HOSTPIN(0x11, 4)
+#define PIN_H5	GLCD_HOSTPIN(0x11, 5)
+#define PIN_H6	GLCD_HOSTPIN(0x11, 6)
+#define PIN_H7	GLCD_HOSTPIN(0x11, 7)
+#define PIN_J0	GLCD_HOSTPIN(0x13, 0)
+#define PIN_J1	GLCD_HOSTPIN(0x13, 1)
+#define PIN_J2	GLCD_HOSTPIN(0x13, 2)
+#define PIN_J3	GLCD_HOSTPIN(0x13, 3)
+#define PIN_J4	GLCD_HOSTPIN(0x13, 4)
+#define PIN_J5	GLCD_HOSTPIN(0x13, 5)
+#define PIN_J6	GLCD_HOSTPIN(0x13, 6)
+#define PIN_J7	GLCD_HOSTPIN(0x13, 7)
+#define PIN_K0	GLCD_HOSTPIN(0x14, 0)
+#define PIN_K1	GLCD_HOSTPIN(0x14, 1)
+#define PIN_K2	GLCD_HOSTPIN(0x14, 2)
+#define PIN_K3	GLCD_HOSTPIN(0x14, 3)
+#define PIN_K4	GLCD_HOSTPIN(0x14, 4)
+#define PIN_K5	GLCD_HOSTPIN(0x14, 5)
+#define PIN_K6	GLCD_HOSTPIN(0x14, 6)
+#define PIN_K7	GLCD_HOSTPIN(0x14, 7)
+#define PIN_L0	GLCD_HOSTPIN(0x15, 0)
+#define PIN_L1	GLCD_HOSTPIN(0x15, 1)
+#define PIN_L2	GLCD_HOSTPIN(0x15, 2)
+#define PIN_L3	GLCD_HOSTPIN(0x15, 3)
+#define PIN_L4	GLCD_HOSTPIN(0x15, 4)
+#define PIN_L5	GLCD_HOSTPIN(0x15, 5)
+#define PIN_L6	GLCD_HOSTPIN(0x15, 6)
+#define PIN_L7	GLCD_HOSTPIN(0x15, 7)
+
+#define lcdfastWrite(pin, pinval)	glcd_EmuWritePin(pin, pinval)
+#define lcdPinMode(pin, mode)
+
+#define lcdDataDir(dirbits)		glcd_EmuDataDir(dirbits)
+#define lcdDataOut(data)		glcd_EmuDataOut(data)
+#define lcdDataIn()				glcd_EmuDataIn()
+
+#define lcdRdBusystatus()		glcd_EmuRdBusystatus()
+
+#define lcdIsBusyStatus(status) (status & LCD_BUSY_FLAG)
+#ifdef LCD_RESET_FLAG
+#define lcdIsResetStatus(status) (status & LCD_RESET_FLAG)
+#else
+#define lcdIsResetStatus(status) 0
+#endif
+
+#ifdef glcdRES
+#define lcdReset()		lcdfastWrite(glcdRES, 0)
+#define lcdUnReset()	lcdfastWrite(glcdRES, 1)
+#else
+#define lcdReset()		
+#define lcdUnReset()		
+#endif
+
+/*
+ * The background flush timer interrupt is called by the emulator
+ */
+#define lcdFlushTimerVect		glcd_EmuTimerVect
+#define lcdFlushTimerStart()	glcd_EmuTimerStart(lcdFlushTimerVect)
+extern "C" void lcdFlushTimerVect(void);
+
+/*
+ * Delays don't wait, they advance the emulated bus clock.
+ */
+#define lcdDelayNanoseconds(__ns)	glcd_EmuDelay(__ns)
+#define lcdDelayMilliseconds(__ms)	delay(__ms)
+
+#endif // GLCD_HOSTIO_H